@@ -0,0 +1,706 @@
+/*
+ * Micro-benchmarks for the HTTP Datetime Parser Library.
+ *
+ * Build & run:
+ *   gcc -O2 -std=c99 -pthread bench.c http_datetime_parser.c -o bench_datetime
+ *   ./bench_datetime
+ *
+ * Header-only build, to compare against the out-of-line one (do not link the .c file):
+ *   gcc -O2 -std=c99 -pthread -DHTTP_DATETIME_HEADER_ONLY bench.c -o bench_header_only
+ *
+ * Allocation counting (GNU ld only) wraps malloc so every heap call made by the
+ * library is tallied:
+ *   gcc -O2 -std=c99 -pthread -DBENCH_COUNT_ALLOCS -Wl,--wrap=malloc \
+ *       bench.c http_datetime_parser.c -o bench_datetime
+ */
+// strptime() for the RFC 3339 baseline
+#define _XOPEN_SOURCE 700
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "http_datetime_parser.h"
+
+#define ITERATIONS 2000000
+
+// Heap allocations so far; atomic because the threaded rows allocate concurrently
+static unsigned long alloc_count = 0;
+
+// alloc_count when the current row's timer started
+static unsigned long alloc_mark = 0;
+
+#ifdef BENCH_COUNT_ALLOCS
+void *__real_malloc(size_t size);
+void *__wrap_malloc(size_t size) {
+    __atomic_fetch_add(&alloc_count, 1, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+#endif
+
+// Monotonic wall clock in nanoseconds
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Starts timing a result row: returns now_ns() and marks the allocation count
+static double start_timer(void) {
+    alloc_mark = __atomic_load_n(&alloc_count, __ATOMIC_RELAXED);
+    return now_ns();
+}
+
+// Prints one result row: ns per operation and heap allocations per operation since start_timer()
+static void report(const char *name, double elapsed_ns, long ops) {
+    printf("%-36s %8.1f ns/op", name, elapsed_ns / (double)ops);
+#ifdef BENCH_COUNT_ALLOCS
+    const unsigned long allocs = __atomic_load_n(&alloc_count, __ATOMIC_RELAXED) - alloc_mark;
+    printf("  %6.2f allocs/op", (double)allocs / (double)ops);
+#endif
+    printf("\n");
+}
+
+// Defeats dead-code elimination of benchmark results
+static volatile int sink;
+
+static void bench_generate_vs_parse(void) {
+    const char *http_date = "Wed, 21 Oct 2015 07:28:00 GMT";
+    double start;
+
+    start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        arcdate_t *date = generate_date(http_date, 0);
+        sink += date->day;
+        free_date(date);
+    }
+    report("generate_date (heap)", now_ns() - start, ITERATIONS);
+
+    start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        arcdate_t date;
+        parse_date(http_date, 0, &date);
+        sink += date.day;
+    }
+    report("parse_date (caller storage)", now_ns() - start, ITERATIONS);
+}
+
+/* 
+ * The sscanf-based decoder that parse_date used before the positional parser,
+ * kept here as the baseline for comparison.
+ */
+static const char *ref_weekdays[] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+static const char *ref_months[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+
+static int sscanf_parse(const char *httpDate, arcdate_t *date) {
+    char weekday[4], month[4];
+    int day, year, hour, minute, second;
+    if (sscanf(httpDate, "%3s, %d %3s %d %d:%d:%d",
+               weekday, &day, month, &year, &hour, &minute, &second) != 7) {
+        return -1;
+    }
+    date->month = 1;
+    for (int i = 0; i < 12; ++i) {
+        if (strcmp(month, ref_months[i]) == 0) { date->month = i + 1; break; }
+    }
+    date->weekday = 0;
+    for (int i = 0; i < 7; ++i) {
+        if (strcmp(weekday, ref_weekdays[i]) == 0) { date->weekday = i; break; }
+    }
+    date->year = year;
+    date->day = day;
+    date->hour = hour;
+    date->minute = minute;
+    date->second = second;
+    date->gmt_offset = 0;
+    return 0;
+}
+
+static void bench_sscanf_vs_positional(void) {
+    const char *http_date = "Sun, 06 Nov 1994 08:49:37 GMT";
+    double start;
+
+    start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        arcdate_t date;
+        if (sscanf_parse(http_date, &date) == 0) sink += date.day;
+    }
+    report("sscanf + strcmp (baseline)", now_ns() - start, ITERATIONS);
+
+    start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        arcdate_t date;
+        if (parse_date(http_date, 0, &date) == ARCDATE_OK) sink += date.day;
+    }
+    report("positional IMF-fixdate", now_ns() - start, ITERATIONS);
+}
+
+/* 
+ * Builds dates the way a cache sees Last-Modified values: most resources changed
+ * recently, so month k back from the newest is drawn with weight ~ 0.8^k across
+ * five years, spreading every month and weekday name with a realistic skew.
+ */
+#define SAMPLE_COUNT 4096
+
+// Threads used by the contention benchmarks
+#define DATE_HEADER_THREADS 32
+static char sample_dates[SAMPLE_COUNT][32];
+
+static void build_sample_dates(void) {
+    const time_t newest = 1735689600; // 2025-01-01T00:00:00Z
+    srand(42);
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        int months_back = 0;
+        while (months_back < 60 && rand() % 5 != 0) months_back++;
+        time_t t = newest - (time_t)months_back * 2629746 - rand() % 2629746;
+        strftime(sample_dates[i], sizeof(sample_dates[i]), "%a, %d %b %Y %H:%M:%S GMT", gmtime(&t));
+    }
+}
+
+static void bench_name_lookup(void) {
+    double start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        arcdate_t date;
+        if (parse_date(sample_dates[i % SAMPLE_COUNT], 0, &date) == ARCDATE_OK) sink += date.month;
+    }
+    report("parse_date, skewed month mix", now_ns() - start, ITERATIONS);
+}
+
+static void bench_epoch_fast_path(void) {
+    double start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        arcdate_t *date = generate_date(sample_dates[i % SAMPLE_COUNT], 0);
+        sink += (int)date_to_epoch(date);
+        free_date(date);
+    }
+    report("generate_date + date_to_epoch", now_ns() - start, ITERATIONS);
+
+    start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        sink += (int)http_date_to_epoch(sample_dates[i % SAMPLE_COUNT], 29);
+    }
+    report("http_date_to_epoch", now_ns() - start, ITERATIONS);
+}
+
+static void bench_legacy_formats(void) {
+    const char *formats[3][2] = {
+        { "Sun, 06 Nov 1994 08:49:37 GMT", "IMF-fixdate -> epoch" },
+        { "Sunday, 06-Nov-94 08:49:37 GMT", "RFC 850 -> epoch" },
+        { "Sun Nov  6 08:49:37 1994", "asctime() -> epoch" },
+    };
+    for (int f = 0; f < 3; f++) {
+        size_t len = strlen(formats[f][0]);
+        double start = start_timer();
+        for (long i = 0; i < ITERATIONS; i++) {
+            sink += (int)http_date_to_epoch(formats[f][0], len);
+        }
+        report(formats[f][1], now_ns() - start, ITERATIONS);
+    }
+}
+
+// Reference RFC 3339 parse: strptime for the fixed part, then the fraction and offset by hand
+static int strptime_rfc3339(const char *s, struct tm *tm, long *nanosecond, int *offset_minutes) {
+    memset(tm, 0, sizeof(*tm));
+    const char *p = strptime(s, "%Y-%m-%dT%H:%M:%S", tm);
+    if (!p) return -1;
+    *nanosecond = 0;
+    if (*p == '.') {
+        char *end;
+        double fraction = strtod(p, &end);
+        *nanosecond = (long)(fraction * 1e9);
+        p = end;
+    }
+    if (*p == 'Z') {
+        *offset_minutes = 0;
+        return 0;
+    }
+    int hh, mm;
+    if (sscanf(p + 1, "%2d:%2d", &hh, &mm) != 2) return -1;
+    *offset_minutes = (*p == '-' ? -1 : 1) * (hh * 60 + mm);
+    return 0;
+}
+
+// The same IMF-fixdate through each kernel this build and CPU support
+static void bench_imf_kernels(void) {
+    const char *http_date = "Sun, 06 Nov 1994 08:49:37 GMT";
+    const struct {
+        arcdate_kernel_t kernel;
+        const char *name;
+    } kernels[] = {
+        { ARCDATE_KERNEL_SCALAR, "IMF-fixdate -> epoch, scalar" },
+        { ARCDATE_KERNEL_SSE42, "IMF-fixdate -> epoch, SSE4.2" },
+        { ARCDATE_KERNEL_AVX2, "IMF-fixdate -> epoch, AVX2" },
+    };
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        if (!set_imf_kernel(kernels[k].kernel)) continue;
+        double start = start_timer();
+        for (long i = 0; i < ITERATIONS; i++) {
+            sink += (int)http_date_to_epoch(http_date, 29);
+        }
+        report(kernels[k].name, now_ns() - start, ITERATIONS);
+    }
+    set_imf_kernel(ARCDATE_KERNEL_AUTO);
+}
+
+static void bench_rfc3339(void) {
+    const char *stamp = "2015-10-21T10:28:00.123+03:00";
+    const size_t len = strlen(stamp);
+
+    double start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        struct tm tm;
+        long nanosecond;
+        int offset;
+        if (strptime_rfc3339(stamp, &tm, &nanosecond, &offset) == 0) sink += tm.tm_min + offset;
+    }
+    report("strptime RFC 3339 (baseline)", now_ns() - start, ITERATIONS);
+
+    start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        arcdate_t date;
+        if (parse_rfc3339(stamp, len, &date) == ARCDATE_OK) sink += date.minute + date.gmt_offset;
+    }
+    report("parse_rfc3339", now_ns() - start, ITERATIONS);
+
+    arcdate_t date;
+    parse_rfc3339(stamp, len, &date);
+    start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        char buf[ARCDATE_RFC3339_MAX];
+        sink += (int)to_rfc3339_buf(&date, buf, sizeof(buf));
+        date.second = (date.second + 1) % 60;
+    }
+    report("to_rfc3339_buf", now_ns() - start, ITERATIONS);
+}
+
+static void bench_batch(void) {
+    static arcdate_span_t spans[SAMPLE_COUNT];
+    static int64_t epochs[SAMPLE_COUNT];
+    const arcdate_batch_t out = { NULL, NULL, NULL, NULL, NULL, NULL, epochs, NULL };
+    const size_t sizes[] = { 1, 16, 256, 4096 };
+
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        spans[i].ptr = sample_dates[i];
+        spans[i].len = strlen(sample_dates[i]);
+    }
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        const size_t batch = sizes[k];
+        const long rounds = ITERATIONS / (long)batch;
+        char name[40];
+
+        double start = start_timer();
+        for (long r = 0; r < rounds; r++) {
+            const arcdate_span_t *in = &spans[(r * batch) % SAMPLE_COUNT];
+            for (size_t i = 0; i < batch; i++) epochs[i] = http_date_to_epoch(in[i].ptr, in[i].len);
+            sink += (int)epochs[0];
+        }
+        snprintf(name, sizeof(name), "http_date_to_epoch loop, n=%zu", batch);
+        report(name, now_ns() - start, rounds * (long)batch);
+
+        start = start_timer();
+        for (long r = 0; r < rounds; r++) {
+            sink += (int)parse_dates_batch(&spans[(r * batch) % SAMPLE_COUNT], batch, &out);
+        }
+        snprintf(name, sizeof(name), "parse_dates_batch, n=%zu", batch);
+        report(name, now_ns() - start, rounds * (long)batch);
+    }
+}
+
+static void bench_batch_parallel(void) {
+    const size_t count = ITERATIONS;
+    arcdate_span_t *spans = malloc(count * sizeof(*spans));
+    int64_t *epochs = malloc(count * sizeof(*epochs));
+    const arcdate_batch_t out = { NULL, NULL, NULL, NULL, NULL, NULL, epochs, NULL };
+    if (!spans || !epochs) {
+        free(spans);
+        free(epochs);
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        spans[i].ptr = sample_dates[i % SAMPLE_COUNT];
+        spans[i].len = strlen(sample_dates[i % SAMPLE_COUNT]);
+    }
+    parse_dates_batch(spans, count, &out); // fault in the output pages before timing
+    for (unsigned int threads = 1; threads <= 64; threads *= 2) {
+        char name[40];
+        double start = start_timer();
+        sink += (int)parse_dates_batch_parallel(spans, count, &out, threads);
+        snprintf(name, sizeof(name), "parse_dates_batch_parallel, %u thr", threads);
+        report(name, now_ns() - start, (long)count);
+    }
+    free(spans);
+    free(epochs);
+}
+
+static void bench_log_extract(void) {
+    const char *path = "bench_access.log";
+    const long lines = ITERATIONS / 4;
+    FILE *log = fopen(path, "wb");
+    if (!log) return;
+    for (long i = 0; i < lines; i++) {
+        fprintf(log, "10.0.%ld.%ld\tGET /index.html\t%s\t200\t5120\n", i / 256 % 256, i % 256,
+                sample_dates[i % SAMPLE_COUNT]);
+    }
+    fclose(log);
+
+    // Baseline: stdio line reading, strtok-style field split and generate_date per line
+    double start = start_timer();
+    log = fopen(path, "rb");
+    char line[256];
+    while (fgets(line, sizeof(line), log)) {
+        char *field = strchr(line, '\t');
+        field = field ? strchr(field + 1, '\t') : NULL;
+        if (!field) continue;
+        char *end = strchr(++field, '\t');
+        if (end) *end = '\0';
+        arcdate_t *date = generate_date(field, 0);
+        if (date) sink += (int)date_to_epoch(date);
+        free_date(date);
+    }
+    fclose(log);
+    report("fgets + generate_date per line", now_ns() - start, lines);
+
+    const arcdate_log_format_t format = { '\0', '\0', '\t', 2 };
+    int64_t *epochs = NULL;
+    size_t count = 0;
+    start = start_timer();
+    if (extract_log_dates(path, &format, &epochs, &count) == ARCDATE_OK) sink += (int)count;
+    report("extract_log_dates (mmap)", now_ns() - start, lines);
+    free(epochs);
+    remove(path);
+}
+
+static void bench_format(void) {
+    arcdate_t date;
+    parse_date("Wed, 21 Oct 2015 07:28:00 GMT", 180, &date);
+    double start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        char buf[ARCDATE_STRING_MAX];
+        sink += snprintf(buf, sizeof(buf), "%s, %02d %s %04d %02d:%02d:%02d GMT%+d",
+                         ref_weekdays[date.weekday], date.day, ref_months[date.month - 1], date.year,
+                         date.hour, date.minute, date.second, date.gmt_offset / 60);
+        date.second = (date.second + 1) % 60;
+    }
+    report("snprintf (baseline)", now_ns() - start, ITERATIONS);
+
+    start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        char *str = to_date_string(&date);
+        sink += str[5];
+        free(str);
+    }
+    report("to_date_string (malloc)", now_ns() - start, ITERATIONS);
+
+    start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        char buf[ARCDATE_STRING_MAX];
+        sink += (int)to_date_string_buf(&date, buf, sizeof(buf));
+        date.second = (date.second + 1) % 60;
+    }
+    report("to_date_string_buf", now_ns() - start, ITERATIONS);
+}
+
+// Field-by-field order of two UTC arcdate_t values, as callers without pack_date() sort them
+static int compare_fields(const void *a, const void *b) {
+    const arcdate_t *x = a, *y = b;
+    if (x->year != y->year) return x->year < y->year ? -1 : 1;
+    if (x->month != y->month) return x->month < y->month ? -1 : 1;
+    if (x->day != y->day) return x->day < y->day ? -1 : 1;
+    if (x->hour != y->hour) return x->hour < y->hour ? -1 : 1;
+    if (x->minute != y->minute) return x->minute < y->minute ? -1 : 1;
+    return (x->second > y->second) - (x->second < y->second);
+}
+
+static int compare_packed(const void *a, const void *b) {
+    arcdate_packed_t x = *(const arcdate_packed_t *)a, y = *(const arcdate_packed_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Call-heavy paths whose cost depends on whether the library is inlined (see HTTP_DATETIME_HEADER_ONLY)
+static void bench_inline_paths(void) {
+    arcdate_t date;
+    parse_date("Wed, 21 Oct 2015 07:28:00 GMT", 0, &date);
+    double start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        add_minutes(&date, 90);
+        sink += date.hour;
+    }
+    report("add_minutes -> add_hours -> add_days", now_ns() - start, ITERATIONS);
+
+    start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        sink += (int)date_to_epoch(&date);
+        date.second = (date.second + 1) % 60;
+    }
+    report("date_to_epoch", now_ns() - start, ITERATIONS);
+
+    start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        sink += parse_date("Wed, 21 Oct 2015 07:28:00 GMT", 0, &date) + date.minute;
+    }
+    report("parse_date, constant input", now_ns() - start, ITERATIONS);
+}
+
+static void bench_convert(void) {
+    const int offsets[4] = { 330, -210, 345, -600 }; // +5:30, -3:30, +5:45, -10:00
+    arcdate_t date;
+    parse_date("Wed, 21 Oct 2015 07:28:00 GMT", 0, &date);
+    double start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        convert(&date, offsets[i & 3]);
+        sink += date.minute;
+    }
+    report("convert, minute offsets", now_ns() - start, ITERATIONS);
+}
+
+static void bench_time_zones(void) {
+    const arcdate_zone_t *berlin = find_zone("Europe/Berlin");
+    const int64_t base = 1445412480; // Wed, 21 Oct 2015 07:28:00 GMT
+
+    // What callers do today: swap TZ around every localtime_r
+    const char *saved = getenv("TZ");
+    double start = start_timer();
+    for (long i = 0; i < ITERATIONS / 16; i++) {
+        time_t t = (time_t)(base + i * 3601);
+        struct tm tm_local;
+        setenv("TZ", "Europe/Berlin", 1);
+        tzset();
+        localtime_r(&t, &tm_local);
+        setenv("TZ", "UTC", 1);
+        tzset();
+        sink += tm_local.tm_hour;
+    }
+    report("setenv TZ + localtime_r (baseline)", now_ns() - start, ITERATIONS / 16);
+
+    setenv("TZ", "Europe/Berlin", 1);
+    tzset();
+    start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        time_t t = (time_t)(base + i * 3601);
+        struct tm tm_local;
+        localtime_r(&t, &tm_local);
+        sink += tm_local.tm_hour;
+    }
+    report("localtime_r, TZ set once", now_ns() - start, ITERATIONS);
+    if (saved) setenv("TZ", saved, 1);
+    else unsetenv("TZ");
+    tzset();
+
+    start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        arcdate_t date;
+        epoch_to_date(base + i * 3601, 0, &date);
+        convert_tz(&date, berlin);
+        sink += date.hour;
+    }
+    report("convert_tz Europe/Berlin", now_ns() - start, ITERATIONS);
+}
+
+// Per-thread registry lookups of already loaded zones
+static void *zone_lookup_worker(void *arg) {
+    const char *const *names = (const char *const *)arg;
+    int local = 0;
+    for (long i = 0; i < ITERATIONS / DATE_HEADER_THREADS; i++) {
+        const arcdate_zone_t *zone;
+        if (load_zone(names[i & 7], &zone) == ARCDATE_OK) local++;
+    }
+    sink += local;
+    return NULL;
+}
+
+static void bench_zone_registry(void) {
+    static const char *const names[8] = {
+        "Europe/Berlin", "America/New_York", "Asia/Kolkata", "Australia/Sydney",
+        "America/Sao_Paulo", "Africa/Cairo", "Pacific/Auckland", "Asia/Tokyo",
+    };
+    const arcdate_zone_t *zone;
+
+    // Every name is loaded from disk exactly once, so this loop runs once
+    double start = start_timer();
+    for (int i = 0; i < 8; i++) {
+        sink += load_zone(names[i], &zone);
+    }
+    report("load_zone, first load (TZif mmap)", now_ns() - start, 8);
+
+    start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        sink += load_zone(names[i & 7], &zone);
+    }
+    report("load_zone, cached", now_ns() - start, ITERATIONS);
+
+    pthread_t threads[DATE_HEADER_THREADS];
+    start = start_timer();
+    for (int t = 0; t < DATE_HEADER_THREADS; t++) {
+        pthread_create(&threads[t], NULL, zone_lookup_worker, (void *)names);
+    }
+    for (int t = 0; t < DATE_HEADER_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    report("load_zone, cached, 32 thr", now_ns() - start, ITERATIONS);
+
+    load_zone("Europe/Berlin", &zone);
+    start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        arcdate_t date;
+        epoch_to_date(1445412480 + i * 3601, 0, &date);
+        convert_tz(&date, zone);
+        sink += date.hour;
+    }
+    report("convert_tz, loaded Europe/Berlin", now_ns() - start, ITERATIONS);
+}
+
+static void bench_packed(void) {
+    static arcdate_t dates[SAMPLE_COUNT], sorted_dates[SAMPLE_COUNT];
+    static arcdate_packed_t packed[SAMPLE_COUNT], sorted_packed[SAMPLE_COUNT];
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        parse_date(sample_dates[i], 0, &dates[i]);
+    }
+    const long rounds = ITERATIONS / SAMPLE_COUNT;
+
+    double start = start_timer();
+    for (long r = 0; r < rounds; r++) {
+        for (int i = 0; i < SAMPLE_COUNT; i++) {
+            packed[i] = pack_date(&dates[i]);
+        }
+        for (int i = 0; i < SAMPLE_COUNT; i++) {
+            sink += unpack_date(packed[i], &sorted_dates[i]);
+        }
+    }
+    report("pack_date + unpack_date", now_ns() - start, rounds * SAMPLE_COUNT);
+
+    start = start_timer();
+    for (long r = 0; r < rounds / 16; r++) {
+        memcpy(sorted_dates, dates, sizeof(dates));
+        qsort(sorted_dates, SAMPLE_COUNT, sizeof(arcdate_t), compare_fields);
+    }
+    report("qsort arcdate_t (36 B, field cmp)", now_ns() - start, rounds / 16 * SAMPLE_COUNT);
+
+    start = start_timer();
+    for (long r = 0; r < rounds / 16; r++) {
+        memcpy(sorted_packed, packed, sizeof(packed));
+        qsort(sorted_packed, SAMPLE_COUNT, sizeof(arcdate_packed_t), compare_packed);
+    }
+    report("qsort arcdate_packed_t (8 B)", now_ns() - start, rounds / 16 * SAMPLE_COUNT);
+    sink += sorted_dates[0].year + (int)sorted_packed[0];
+}
+
+static void bench_conditional(void) {
+    const int64_t mtime = 1445412480; // Wed, 21 Oct 2015 07:28:00 GMT
+    double start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        arcdate_t *date = generate_date(sample_dates[i % SAMPLE_COUNT], 0);
+        if (date) sink += date_to_epoch(date) >= mtime ? 304 : 200;
+        free_date(date);
+    }
+    report("IMS via generate_date + epoch", now_ns() - start, ITERATIONS);
+
+    start = start_timer();
+    for (long i = 0; i < ITERATIONS; i++) {
+        sink += if_modified_since(sample_dates[i % SAMPLE_COUNT], 29, mtime);
+    }
+    report("if_modified_since", now_ns() - start, ITERATIONS);
+}
+
+
+// Per-thread "now" loop; arg selects parse_date(NULL) (non-zero) or time + gmtime_r
+static void *now_worker(void *arg) {
+    int library = *(const int *)arg;
+    int local = 0;
+    for (long i = 0; i < ITERATIONS / DATE_HEADER_THREADS; i++) {
+        if (library) {
+            arcdate_t date;
+            parse_date(NULL, 0, &date);
+            local += date.second;
+        } else {
+            time_t now = time(NULL);
+            struct tm tm_utc;
+            gmtime_r(&now, &tm_utc);
+            local += tm_utc.tm_sec;
+        }
+    }
+    sink += local;
+    return NULL;
+}
+
+static void bench_now_contention(void) {
+    const char *names[3] = { "now: time + gmtime_r, 32 thr", "now: parse_date(NULL), 32 thr",
+                             "now: coarse parse_date(NULL), 32 thr" };
+    for (int mode = 0; mode < 3; mode++) {
+        int library = mode > 0;
+        set_coarse_clock(mode == 2);
+        pthread_t threads[DATE_HEADER_THREADS];
+        double start = start_timer();
+        for (int t = 0; t < DATE_HEADER_THREADS; t++) {
+            pthread_create(&threads[t], NULL, now_worker, &library);
+        }
+        for (int t = 0; t < DATE_HEADER_THREADS; t++) {
+            pthread_join(threads[t], NULL);
+        }
+        report(names[mode], now_ns() - start, ITERATIONS);
+    }
+    set_coarse_clock(false);
+}
+
+// Per-thread Date header loop; arg selects the cached formatter (non-zero) or the malloc path
+static void *date_header_worker(void *arg) {
+    int cached = *(const int *)arg;
+    int local = 0;
+    for (long i = 0; i < ITERATIONS / DATE_HEADER_THREADS; i++) {
+        if (cached) {
+            local += http_date_now()[5];
+        } else {
+            arcdate_t *date = generate_date(NULL, 0);
+            char *str = to_date_string(date);
+            local += str[5];
+            free(str);
+            free_date(date);
+        }
+    }
+    sink += local;
+    return NULL;
+}
+
+static void bench_date_header_threads(void) {
+    const char *names[2] = { "Date header, malloc path, 32 thr", "Date header, http_date_now, 32 thr" };
+    for (int cached = 0; cached < 2; cached++) {
+        pthread_t threads[DATE_HEADER_THREADS];
+        double start = start_timer();
+        for (int t = 0; t < DATE_HEADER_THREADS; t++) {
+            pthread_create(&threads[t], NULL, date_header_worker, &cached);
+        }
+        for (int t = 0; t < DATE_HEADER_THREADS; t++) {
+            pthread_join(threads[t], NULL);
+        }
+        report(names[cached], now_ns() - start, ITERATIONS);
+    }
+}
+
+int main(void) {
+#ifdef HTTP_DATETIME_HEADER_ONLY
+    printf("HTTP Datetime Parser benchmarks (%d iterations, header-only build)\n", ITERATIONS);
+#else
+    printf("HTTP Datetime Parser benchmarks (%d iterations)\n", ITERATIONS);
+#endif
+    bench_generate_vs_parse();
+    bench_sscanf_vs_positional();
+    build_sample_dates();
+    bench_name_lookup();
+    bench_epoch_fast_path();
+    bench_legacy_formats();
+    bench_imf_kernels();
+    bench_rfc3339();
+    bench_batch();
+    bench_batch_parallel();
+    bench_log_extract();
+    bench_format();
+    bench_inline_paths();
+    bench_convert();
+    bench_time_zones();
+    bench_zone_registry();
+    bench_packed();
+    bench_conditional();
+    bench_date_header_threads();
+    bench_now_contention();
+    return 0;
+}
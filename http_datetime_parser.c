@@ -43,13 +43,66 @@
  *
  * License: MIT License
  * Author: Arda 'Arc' Akgür (Original Concept and Core Logic)
- * Version: 1.0 (2025 Edition)
+ * Version: 2.0 (2025 Edition)
  */
+// POSIX threads and clocks are used when available; must precede every system header
+#if !defined(_POSIX_C_SOURCE) && !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#endif
 #include "http_datetime_parser.h"
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+
+// parse_dates_batch_parallel() uses pthreads on POSIX systems; define HTTP_DATETIME_NO_THREADS
+// to build without them, in which case it parses on the calling thread
+#if !defined(HTTP_DATETIME_NO_THREADS) && (defined(__unix__) || defined(__APPLE__))
+#define HTTP_DATETIME_PTHREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+// extract_log_dates() maps files with mmap on POSIX systems and reads them whole elsewhere
+#if defined(__unix__) || defined(__APPLE__)
+#define HTTP_DATETIME_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <stdio.h>
+#endif
+
+// x86 SIMD kernels need GCC/Clang target attributes; define HTTP_DATETIME_NO_SIMD to
+// build only the scalar parser, or HTTP_DATETIME_NO_AVX2 to stop at SSE4.2
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(HTTP_DATETIME_NO_SIMD)
+#define HTTP_DATETIME_X86_SIMD
+#include <immintrin.h>
+#endif
+
+// Lock-free publication for shared caches. Needs the GCC/Clang __atomic builtins: plain
+// loads and stores would not be thread-safe, so other compilers are refused outright
+#if defined(__GNUC__) || defined(__clang__)
+#define ATOMIC_LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define ATOMIC_STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define ATOMIC_TRY_LOCK(p) (!__atomic_test_and_set((p), __ATOMIC_ACQUIRE))
+#define ATOMIC_UNLOCK(p) __atomic_clear((p), __ATOMIC_RELEASE)
+#define ATOMIC_CAS(p, expected, v) \
+    __atomic_compare_exchange_n((p), (expected), (v), false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#else
+#error "http_datetime_parser needs GCC or Clang __atomic builtins for its thread-safe caches"
+#endif
+
+// Per-thread storage for the coarse "now" cache; without it the cache is skipped
+#if defined(__GNUC__) || defined(__clang__)
+#define THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#endif
+
+// longest HTTP-date: RFC 850 with "Wednesday", e.g. "Wednesday, 21-Oct-15 07:28:00 GMT"
+#define HTTP_DATE_MAX_LEN 33
 // how many days in given month
 static const int month_days[12] = { 31,28,31,30,31,30,31,31,30,31,30,31 };
 // week day names
@@ -57,6 +110,36 @@ static const char *weekday_names[] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri",
 //  month names
 static const char *month_names[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
 
+/*
+ * Perfect hashes for month and weekday names. A name is packed little-endian into
+ * a uint32, lower-cased by OR-ing 0x20 into each byte, multiplied and reduced to
+ * its top bits; the multipliers were searched offline so that every name lands in
+ * its own slot. A lookup is one multiply, one load and one compare against the
+ * canonical spelling. Define HTTP_DATETIME_CASE_INSENSITIVE to also accept names
+ * in any letter case (RFC 7231 names are case-sensitive).
+ */
+#define PACK3(a, b, c) ((uint32_t)(a) | (uint32_t)(b) << 8 | (uint32_t)(c) << 16)
+#define NAME_CASE_BITS PACK3(0x20, 0x20, 0x20)
+#define MONTH_HASH(key) ((uint32_t)((key) * 0x67E5u) >> 28)
+#define WEEKDAY_HASH(key) ((uint32_t)((key) * 0x131Fu) >> 29)
+
+typedef struct {
+    uint32_t key; // canonical packed name, 0 for an empty slot
+    int value;    // month (1-12) or weekday (0-6), 0 / -1 for an empty slot
+} name_slot_t;
+
+static const name_slot_t month_slots[16] = {
+    { PACK3('J','u','l'), 7 },  { PACK3('N','o','v'), 11 }, { 0, 0 },                   { PACK3('O','c','t'), 10 },
+    { PACK3('M','a','y'), 5 },  { PACK3('D','e','c'), 12 }, { PACK3('M','a','r'), 3 },  { PACK3('A','p','r'), 4 },
+    { 0, 0 },                   { PACK3('S','e','p'), 9 },  { 0, 0 },                   { 0, 0 },
+    { PACK3('J','a','n'), 1 },  { PACK3('J','u','n'), 6 },  { PACK3('F','e','b'), 2 },  { PACK3('A','u','g'), 8 },
+};
+
+static const name_slot_t weekday_slots[8] = {
+    { 0, -1 },                  { PACK3('M','o','n'), 1 },  { PACK3('S','u','n'), 0 },  { PACK3('W','e','d'), 3 },
+    { PACK3('T','u','e'), 2 },  { PACK3('S','a','t'), 6 },  { PACK3('T','h','u'), 4 },  { PACK3('F','r','i'), 5 },
+};
+
 /* 
  * Checks if a given year is a leap year.
  * Returns true if leap year, false otherwise.
@@ -79,201 +162,2222 @@ static int days_in_month(int month, int year) {
     return month_days[month - 1];
 }
 
+/* 
+ * Converts a proleptic Gregorian date to the number of days since 1970-01-01
+ * (negative before the epoch). Closed form after Howard Hinnant's days_from_civil:
+ * years are shifted to start in March so the leap day falls at the end of the year.
+ */
+static int64_t days_from_civil(int64_t year, int month, int day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int64_t yoe = year - era * 400;                                      // [0, 399]
+    const int64_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1; // [0, 365]
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;                 // [0, 146096]
+    return era * 146097 + doe - 719468;
+}
+
+/* 
+ * Weekday (0 = Sunday) of a day number from days_from_civil(); 1970-01-01 was a Thursday.
+ */
+static int weekday_from_days(int64_t days) {
+    return (int)((days % 7 + 11) % 7);
+}
+
+/* 
+ * Inverse of days_from_civil(): stores the year, month, day and weekday of the
+ * given day number into date. Other fields are left untouched.
+ */
+static void civil_from_days(int64_t serial, arcdate_t *date) {
+    date->weekday = weekday_from_days(serial);
+
+    serial += 719468;
+    const int64_t era = (serial >= 0 ? serial : serial - 146096) / 146097;
+    const int64_t doe = serial - era * 146097;                             // [0, 146096]
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365; // [0, 399]
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);           // [0, 365]
+    const int64_t mp = (5 * doy + 2) / 153;                                // [0, 11]
+    const int month = (int)(mp < 10 ? mp + 3 : mp - 9);
+
+    date->year = (int)(yoe + era * 400 + (month <= 2));
+    date->month = month;
+    date->day = (int)(doy - (153 * mp + 2) / 5 + 1);
+}
+
+// Set by set_coarse_clock(); read on every clock access
+static bool coarse_clock = false;
+
+/* 
+ * Reads the wall clock as Unix time, storing the fraction of the second in
+ * *nanosecond when it is not NULL. Thread-safe and allocation-free: no libc
+ * broken-down time is involved. In coarse mode CLOCK_REALTIME_COARSE is read
+ * instead, which skips the hardware counter at the cost of tick resolution.
+ */
+static int64_t read_wall_clock(int *nanosecond) {
+    struct timespec ts;
+#ifdef CLOCK_REALTIME_COARSE
+    if (ATOMIC_LOAD_ACQUIRE(&coarse_clock) && clock_gettime(CLOCK_REALTIME_COARSE, &ts) == 0) {
+        if (nanosecond) *nanosecond = (int)ts.tv_nsec;
+        return (int64_t)ts.tv_sec;
+    }
+#endif
+#ifdef CLOCK_REALTIME
+    if (clock_gettime(CLOCK_REALTIME, &ts) == 0) {
+        if (nanosecond) *nanosecond = (int)ts.tv_nsec;
+        return (int64_t)ts.tv_sec;
+    }
+#endif
+    (void)ts;
+    if (nanosecond) *nanosecond = 0;
+    return (int64_t)time(NULL);
+}
+
+#ifdef THREAD_LOCAL
+// Last coarse-mode "now" decomposed by this thread, keyed by second and offset
+static THREAD_LOCAL int64_t now_cache_second = INT64_MIN;
+static THREAD_LOCAL arcdate_t now_cache_date;
+#endif
+
+// UTC fields decoded from a HTTP Date, before any offset or weekday handling
+typedef struct {
+    int year, month, day, hour, minute, second;
+} http_fields_t;
+
+/* 
+ * Packs three name bytes into the low 24 bits of a uint32 for single-compare matching.
+ */
+static uint32_t load_name3(const char *str) {
+    return (uint32_t)(unsigned char)str[0] |
+           (uint32_t)(unsigned char)str[1] << 8 |
+           (uint32_t)(unsigned char)str[2] << 16;
+}
+
 /* 
  * Parses a three-letter month abbreviation (e.g., "Oct") into its month number (1-12).
- * Defaults to January (1) if parsing fails.
+ * Reads exactly three bytes; the input need not be NUL-terminated.
+ * Returns 0 if the bytes do not name a month.
  */
 static int parse_month(const char *str) {
-    for (int i = 0; i < 12; ++i) {
-        if (strcmp(str, month_names[i]) == 0)
-            return i + 1;
-    }
-    return 1; // Default January if parse fails
+    uint32_t key = load_name3(str);
+    const name_slot_t *slot = &month_slots[MONTH_HASH(key | NAME_CASE_BITS)];
+#ifdef HTTP_DATETIME_CASE_INSENSITIVE
+    key |= NAME_CASE_BITS;
+    return key == (slot->key | NAME_CASE_BITS) ? slot->value : 0;
+#else
+    return key == slot->key ? slot->value : 0;
+#endif
 }
 
 /* 
  * Parses a three-letter weekday abbreviation (e.g., "Wed") into its day index (0=Sun, 1=Mon, etc.).
- * Defaults to Sunday (0) if parsing fails.
+ * Reads exactly three bytes; the input need not be NUL-terminated.
+ * Returns -1 if the bytes do not name a weekday.
  */
 static int parse_weekday(const char *str) {
-    for (int i = 0; i < 7; ++i) {
-        if (strcmp(str, weekday_names[i]) == 0)
-            return i;
+    uint32_t key = load_name3(str);
+    const name_slot_t *slot = &weekday_slots[WEEKDAY_HASH(key | NAME_CASE_BITS)];
+#ifdef HTTP_DATETIME_CASE_INSENSITIVE
+    key |= NAME_CASE_BITS;
+    return key == (slot->key | NAME_CASE_BITS) ? slot->value : -1;
+#else
+    return key == slot->key ? slot->value : -1;
+#endif
+}
+
+/* 
+ * Decodes two ASCII digits into 0-99.
+ * Returns -1 if either byte is not a digit.
+ */
+static int parse_2digits(const char *p) {
+    unsigned int hi = (unsigned char)p[0] - '0';
+    unsigned int lo = (unsigned char)p[1] - '0';
+    if (hi > 9 || lo > 9) return -1;
+    return (int)(hi * 10 + lo);
+}
+
+/* 
+ * Scalar kernel: validates the punctuation and digit positions of a 29-byte
+ * IMF-fixdate ("Sun, 06 Nov 1994 08:49:37 GMT", RFC 7231 7.1.1.1) in a single
+ * positional pass and decodes day, year, hour, minute and second into fields.
+ */
+static bool decode_imf_fixdate_scalar(const char *s, int fields[5]) {
+    if (s[3] != ',' || s[4] != ' ' || s[7] != ' ' || s[11] != ' ' || s[16] != ' ' ||
+        s[19] != ':' || s[22] != ':' || s[25] != ' ' ||
+        s[26] != 'G' || s[27] != 'M' || s[28] != 'T') {
+        return false;
+    }
+
+    int day = parse_2digits(s + 5);
+    int century = parse_2digits(s + 12);
+    int year_lo = parse_2digits(s + 14);
+    int hour = parse_2digits(s + 17);
+    int minute = parse_2digits(s + 20);
+    int second = parse_2digits(s + 23);
+
+    if ((day | century | year_lo | hour | minute | second) < 0) return false;
+    fields[0] = day;
+    fields[1] = century * 100 + year_lo;
+    fields[2] = hour;
+    fields[3] = minute;
+    fields[4] = second;
+    return true;
+}
+
+#ifdef HTTP_DATETIME_X86_SIMD
+/* 
+ * SSE4.2 kernel: same contract as the scalar one. The 29 bytes are covered by
+ * two overlapping 16-byte loads (bytes 0-15 and 13-28). Punctuation is checked
+ * with one compare per half, digit positions with an unsigned range check, and
+ * the twelve digits are gathered with pshufb and folded into six 0-99 values
+ * with one pmaddubsw.
+ */
+__attribute__((target("sse4.2")))
+static bool decode_imf_fixdate_sse42(const char *s, int fields[5]) {
+    const __m128i lo = _mm_loadu_si128((const __m128i *)s);
+    const __m128i hi = _mm_loadu_si128((const __m128i *)(s + 13));
+
+    // Expected punctuation; only the bits in the masks below are compared
+    const __m128i lo_tmpl = _mm_setr_epi8(0, 0, 0, ',', ' ', 0, 0, ' ', 0, 0, 0, ' ', 0, 0, 0, 0);
+    const __m128i hi_tmpl = _mm_setr_epi8(0, 0, 0, ' ', 0, 0, ':', 0, 0, ':', 0, 0, ' ', 'G', 'M', 'T');
+    const int lo_punct = (1 << 3) | (1 << 4) | (1 << 7) | (1 << 11);
+    const int hi_punct = (1 << 3) | (1 << 6) | (1 << 9) | (1 << 12) | (1 << 13) | (1 << 14) | (1 << 15);
+    const int lo_digits = (1 << 5) | (1 << 6) | (1 << 12) | (1 << 13) | (1 << 14) | (1 << 15);
+    const int hi_digits = (1 << 4) | (1 << 5) | (1 << 7) | (1 << 8) | (1 << 10) | (1 << 11);
+
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i dlo = _mm_sub_epi8(lo, zero);
+    const __m128i dhi = _mm_sub_epi8(hi, zero);
+    int lo_ok = _mm_movemask_epi8(_mm_cmpeq_epi8(lo, lo_tmpl)) & lo_punct;
+    int hi_ok = _mm_movemask_epi8(_mm_cmpeq_epi8(hi, hi_tmpl)) & hi_punct;
+    lo_ok |= _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(dlo, nine), dlo)) & lo_digits;
+    hi_ok |= _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(dhi, nine), dhi)) & hi_digits;
+    if (lo_ok != (lo_punct | lo_digits) || hi_ok != (hi_punct | hi_digits)) return false;
+
+    // Gather the digits as day, century, year, hour, minute, second pairs
+    const __m128i lo_gather = _mm_setr_epi8(5, 6, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i hi_gather = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 4, 5, 7, 8, 10, 11, -1, -1, -1, -1);
+    const __m128i digits = _mm_or_si128(_mm_shuffle_epi8(dlo, lo_gather), _mm_shuffle_epi8(dhi, hi_gather));
+    const __m128i pairs = _mm_maddubs_epi16(digits, _mm_set1_epi16(0x010A));
+
+    fields[0] = _mm_extract_epi16(pairs, 0);
+    fields[1] = _mm_extract_epi16(pairs, 1) * 100 + _mm_extract_epi16(pairs, 2);
+    fields[2] = _mm_extract_epi16(pairs, 3);
+    fields[3] = _mm_extract_epi16(pairs, 4);
+    fields[4] = _mm_extract_epi16(pairs, 5);
+    return true;
+}
+
+#ifndef HTTP_DATETIME_NO_AVX2
+/* 
+ * AVX2 kernel: same contract as the scalar one. The whole IMF-fixdate fits one
+ * 32-byte register, assembled from two 16-byte loads so nothing past the 29th
+ * byte is read. Punctuation and digit positions are validated with a single
+ * compare each, and pshufb + pmaddubsw convert the digit pairs of both 128-bit
+ * lanes at once.
+ */
+__attribute__((target("avx2")))
+static bool decode_imf_fixdate_avx2(const char *s, int fields[5]) {
+    const __m128i lo = _mm_loadu_si128((const __m128i *)s);
+    const __m128i hi = _mm_srli_si128(_mm_loadu_si128((const __m128i *)(s + 13)), 3);
+    const __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+    const __m256i tmpl = _mm256_setr_epi8(0, 0, 0, ',', ' ', 0, 0, ' ', 0, 0, 0, ' ', 0, 0, 0, 0,
+                                          ' ', 0, 0, ':', 0, 0, ':', 0, 0, ' ', 'G', 'M', 'T', 0, 0, 0);
+    const unsigned int punct = (1u << 3) | (1u << 4) | (1u << 7) | (1u << 11) | (1u << 16) |
+                               (1u << 19) | (1u << 22) | (1u << 25) | (1u << 26) | (1u << 27) | (1u << 28);
+    const unsigned int digit_pos = (1u << 5) | (1u << 6) | (1u << 12) | (1u << 13) | (1u << 14) | (1u << 15) |
+                                   (1u << 17) | (1u << 18) | (1u << 20) | (1u << 21) | (1u << 23) | (1u << 24);
+
+    const __m256i d = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+    unsigned int ok = (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, tmpl)) & punct;
+    ok |= (unsigned int)_mm256_movemask_epi8(
+              _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d)) & digit_pos;
+    if (ok != (punct | digit_pos)) return false;
+
+    // Low lane: day, century, year; high lane: hour, minute, second
+    const __m256i gather = _mm256_setr_epi8(5, 6, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                            1, 2, 4, 5, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i pairs = _mm256_maddubs_epi16(_mm256_shuffle_epi8(d, gather), _mm256_set1_epi16(0x010A));
+
+    const __m128i date_pairs = _mm256_castsi256_si128(pairs);
+    const __m128i time_pairs = _mm256_extracti128_si256(pairs, 1);
+    fields[0] = _mm_extract_epi16(date_pairs, 0);
+    fields[1] = _mm_extract_epi16(date_pairs, 1) * 100 + _mm_extract_epi16(date_pairs, 2);
+    fields[2] = _mm_extract_epi16(time_pairs, 0);
+    fields[3] = _mm_extract_epi16(time_pairs, 1);
+    fields[4] = _mm_extract_epi16(time_pairs, 2);
+    return true;
+}
+#endif
+#endif
+
+// Validates and decodes the digits of a 29-byte IMF-fixdate (day, year, hour, minute, second)
+typedef bool (*imf_kernel_t)(const char *s, int fields[5]);
+
+// Set by set_imf_kernel(); read on every parse
+static arcdate_kernel_t imf_kernel_choice = ARCDATE_KERNEL_AUTO;
+
+/* 
+ * Returns the kernel for choice, or NULL if it is not compiled in or the CPU
+ * lacks the instructions. AUTO prefers SSE4.2 over AVX2, which measured no
+ * faster: the 29-byte input needs a cross-lane insert before the AVX2 compare.
+ */
+static imf_kernel_t imf_kernel_for(arcdate_kernel_t choice) {
+    switch (choice) {
+    case ARCDATE_KERNEL_SCALAR:
+        return decode_imf_fixdate_scalar;
+#ifdef HTTP_DATETIME_X86_SIMD
+    case ARCDATE_KERNEL_SSE42:
+        return __builtin_cpu_supports("sse4.2") ? decode_imf_fixdate_sse42 : NULL;
+#ifndef HTTP_DATETIME_NO_AVX2
+    case ARCDATE_KERNEL_AVX2:
+        return __builtin_cpu_supports("avx2") ? decode_imf_fixdate_avx2 : NULL;
+#endif
+    case ARCDATE_KERNEL_AUTO:
+        return __builtin_cpu_supports("sse4.2") ? decode_imf_fixdate_sse42 : decode_imf_fixdate_scalar;
+#else
+    case ARCDATE_KERNEL_AUTO:
+        return decode_imf_fixdate_scalar;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+/* 
+ * Returns the IMF-fixdate kernel chosen with set_imf_kernel(), by default the
+ * fastest one the CPU supports.
+ */
+static imf_kernel_t select_imf_kernel(void) {
+    return imf_kernel_for(ATOMIC_LOAD_ACQUIRE(&imf_kernel_choice));
+}
+
+/* 
+ * Resolves the month name at s and range-checks the decoded numbers, storing
+ * them into fields. Shared by all three HTTP-date formats.
+ */
+static bool store_http_fields(const char *month_name, int year, int day, int hour, int minute, int second,
+                              http_fields_t *fields) {
+    int month = parse_month(month_name);
+    if (month == 0) return false;
+    if (day < 1 || day > days_in_month(month, year)) return false;
+    if (hour > 23 || minute > 59 || second > 60) return false;
+
+    fields->year = year;
+    fields->month = month;
+    fields->day = day;
+    fields->hour = hour;
+    fields->minute = minute;
+    fields->second = second;
+    return true;
+}
+
+/* 
+ * Decodes an IMF-fixdate of exactly len bytes into fields. Name lookup and range
+ * checks are shared so every kernel accepts exactly the same inputs; keeping them
+ * outside the kernels also means the AVX2 path returns (and clears the upper
+ * register state) before any scalar code runs.
+ * Returns false if the input is not a valid IMF-fixdate; fields is then unspecified.
+ */
+static bool decode_imf_fixdate(imf_kernel_t kernel, const char *s, size_t len, http_fields_t *fields) {
+    int f[5];
+    if (len != ARCDATE_IMF_FIXDATE_LEN || !kernel(s, f)) return false;
+    if (parse_weekday(s) < 0) return false;
+    return store_http_fields(s + 8, f[1], f[0], f[2], f[3], f[4], fields);
+}
+
+// RFC 850 century window: the UTC instant the cached year ends, shifted left 16, with the
+// year in the low 16 bits, so one atomic load reads both; 0 until the first RFC 850 parse
+static int64_t rfc850_year_cache = 0;
+
+/* 
+ * Expands the two-digit year of an RFC 850 date per RFC 7231 7.1.1.1: a year that
+ * would lie more than 50 years in the future is taken from the previous century.
+ * The current year is cached until the next 1 January UTC, so most calls cost a
+ * time() read (the kernel's coarse clock) instead of a full clock_gettime() and
+ * calendar conversion; a racing refresh only stores the same value twice.
+ */
+static int expand_rfc850_year(int yy) {
+    int64_t cache = ATOMIC_LOAD_ACQUIRE(&rfc850_year_cache);
+    if ((int64_t)time(NULL) >= cache >> 16) {
+        const int64_t now = read_wall_clock(NULL);
+        arcdate_t today;
+        civil_from_days(now / 86400 - (now % 86400 < 0), &today);
+        cache = days_from_civil(today.year + 1, 1, 1) * 86400 * 65536 + today.year;
+        ATOMIC_STORE_RELEASE(&rfc850_year_cache, cache);
+    }
+    const int current = (int)(cache & 0xFFFF);
+
+    int year = current - current % 100 + yy;
+    if (year < current - 49) year += 100;
+    if (year > current + 50) year -= 100;
+    return year;
+}
+
+/* 
+ * Decodes an obsolete RFC 850 date ("Sunday, 06-Nov-94 08:49:37 GMT"). The full
+ * weekday name fixes the length; the remaining 24 bytes are checked positionally.
+ */
+static bool decode_rfc850_date(const char *s, size_t len, http_fields_t *fields) {
+    // Weekday name endings after the three-letter abbreviation, e.g. "Wed" + "nesday"
+    static const char *const endings[7] = { "day", "day", "sday", "nesday", "rsday", "day", "urday" };
+    static const size_t ending_lens[7] = { 3, 3, 4, 6, 5, 3, 5 };
+
+    if (len < 30) return false;
+    int weekday = parse_weekday(s);
+    if (weekday < 0 || len != 3 + ending_lens[weekday] + 24) return false;
+    if (memcmp(s + 3, endings[weekday], ending_lens[weekday]) != 0) return false;
+
+    const char *p = s + 3 + ending_lens[weekday]; // ", 06-Nov-94 08:49:37 GMT"
+    if (p[0] != ',' || p[1] != ' ' || p[4] != '-' || p[8] != '-' || p[11] != ' ' ||
+        p[14] != ':' || p[17] != ':' || memcmp(p + 20, " GMT", 4) != 0) {
+        return false;
+    }
+
+    int day = parse_2digits(p + 2);
+    int yy = parse_2digits(p + 9);
+    int hour = parse_2digits(p + 12);
+    int minute = parse_2digits(p + 15);
+    int second = parse_2digits(p + 18);
+    if ((day | yy | hour | minute | second) < 0) return false;
+    return store_http_fields(p + 5, expand_rfc850_year(yy), day, hour, minute, second, fields);
+}
+
+/* 
+ * Decodes an ANSI C asctime() date ("Sun Nov  6 08:49:37 1994"), whose day of
+ * month is space-padded to two characters.
+ */
+static bool decode_asctime_date(const char *s, size_t len, http_fields_t *fields) {
+    if (len != 24) return false;
+    if (s[3] != ' ' || s[7] != ' ' || s[10] != ' ' || s[13] != ':' || s[16] != ':' || s[19] != ' ') {
+        return false;
+    }
+    if (parse_weekday(s) < 0) return false;
+
+    int day;
+    if (s[8] == ' ') {
+        unsigned int d = (unsigned char)s[9] - '0';
+        day = d > 9 ? -1 : (int)d;
+    } else {
+        day = parse_2digits(s + 8);
+    }
+    int century = parse_2digits(s + 20);
+    int year_lo = parse_2digits(s + 22);
+    int hour = parse_2digits(s + 11);
+    int minute = parse_2digits(s + 14);
+    int second = parse_2digits(s + 17);
+    if ((day | century | year_lo | hour | minute | second) < 0) return false;
+    return store_http_fields(s + 4, century * 100 + year_lo, day, hour, minute, second, fields);
+}
+
+/* 
+ * Decodes any of the three RFC 7231 HTTP-date formats. All of them start with a
+ * three-letter weekday, so the fourth byte alone selects the parser:
+ * ',' for IMF-fixdate, ' ' for asctime() and a letter for RFC 850.
+ * kernel is the IMF-fixdate kernel from select_imf_kernel().
+ */
+static bool decode_http_date(imf_kernel_t kernel, const char *s, size_t len, http_fields_t *fields) {
+    if (len < 24) return false;
+    switch (s[3]) {
+        case ',': return decode_imf_fixdate(kernel, s, len, fields);
+        case ' ': return decode_asctime_date(s, len, fields);
+        default:  return decode_rfc850_date(s, len, fields);
     }
-    return 0; // Default Sunday
 }
+
+/* 
+ * Converts decoded UTC fields to Unix time.
+ */
+static int64_t fields_to_epoch(const http_fields_t *f) {
+    return days_from_civil(f->year, f->month, f->day) * 86400 + f->hour * 3600 + f->minute * 60 + f->second;
+}
+
 /**
- * @brief Generates an arcdate_t object from a HTTP Date string or system time.
+ * @brief Fills a caller-provided arcdate_t from a HTTP Date string or system time.
  *
- * @param httpDate A HTTP Date string (e.g., "Wed, 21 Oct 2015 07:28:00 GMT"), or NULL for current system UTC time.
- * @param gmt_offset Desired GMT offset to apply (e.g., 0, +3, -5).
- * @return Pointer to a dynamically allocated arcdate_t structure. Must be freed using free_date().
+ * Performs no heap allocation, so the target may live on the stack or in an arena.
+ *
+ * @param httpDate A HTTP Date string in any RFC 7231 format ("Wed, 21 Oct 2015 07:28:00 GMT",
+ *                 "Wednesday, 21-Oct-15 07:28:00 GMT" or "Wed Oct 21 07:28:00 2015"),
+ *                 or NULL for current system UTC time (read with clock_gettime, thread-safe).
+ * @param gmt_offset Desired GMT offset to apply, in minutes (e.g., 0, +180, -300, +330).
+ * @param date Pointer to the arcdate_t structure to fill.
+ * @return ARCDATE_OK on success, ARCDATE_ERR_NULL if date is NULL,
+ *         ARCDATE_ERR_FORMAT if httpDate could not be parsed (date is left untouched).
  */
-arcdate_t* generate_date(const char *httpDate, int gmt_offset) {
-    arcdate_t *date = (arcdate_t*)malloc(sizeof(arcdate_t));
-    if (!date) return NULL;
+HTTP_DATETIME_API arcdate_status_t parse_date(const char *httpDate, int gmt_offset, arcdate_t *date) {
+    if (!date) return ARCDATE_ERR_NULL;
 
     if (httpDate == NULL) {
-        time_t now = time(NULL);
-        struct tm *tm_utc = gmtime(&now);
-
-        date->year = tm_utc->tm_year + 1900;
-        date->month = tm_utc->tm_mon + 1;
-        date->day = tm_utc->tm_mday;
-        date->hour = tm_utc->tm_hour;
-        date->minute = tm_utc->tm_min;
-        date->second = tm_utc->tm_sec;
-        date->weekday = tm_utc->tm_wday;
-    } else {
-        // Parse format: "Wed, 21 Oct 2015 07:28:00 GMT"
-        char weekday[4], month[4];
-        int day, year, hour, minute, second;
-        sscanf(httpDate, "%3s, %d %3s %d %d:%d:%d", 
-               weekday, &day, month, &year, &hour, &minute, &second);
-
-        date->year = year;
-        date->month = parse_month(month);
-        date->day = day;
-        date->hour = hour;
-        date->minute = minute;
-        date->second = second;
-        date->weekday = parse_weekday(weekday);
+        // No gmtime(): its shared static result is unsafe across threads
+        int nanosecond;
+        const int64_t now = read_wall_clock(&nanosecond);
+#ifdef THREAD_LOCAL
+        if (ATOMIC_LOAD_ACQUIRE(&coarse_clock)) {
+            if (now != now_cache_second || now_cache_date.gmt_offset != gmt_offset) {
+                epoch_to_date(now, gmt_offset, &now_cache_date);
+                now_cache_second = now;
+            }
+            *date = now_cache_date;
+            date->nanosecond = nanosecond;
+            return ARCDATE_OK;
+        }
+#endif
+        epoch_to_date(now, gmt_offset, date);
+        date->nanosecond = nanosecond;
+        return ARCDATE_OK;
+    }
+
+    // IMF-fixdate, RFC 850 or asctime() format
+    size_t len = 0;
+    while (len <= HTTP_DATE_MAX_LEN && httpDate[len] != '\0') len++;
+    http_fields_t f;
+    if (!decode_http_date(select_imf_kernel(), httpDate, len, &f)) {
+        return ARCDATE_ERR_FORMAT;
     }
-    
+
+    date->year = f.year;
+    date->month = f.month;
+    date->day = f.day;
+    date->hour = f.hour;
+    date->minute = f.minute;
+    date->second = f.second;
     date->gmt_offset = gmt_offset;
-    add_hours(date, gmt_offset); // Adjust to desired GMT immediately
-    return date;
+    date->nanosecond = 0;
+    add_minutes(date, gmt_offset); // Adjust to desired GMT immediately
+    return ARCDATE_OK;
 }
+
 /**
- * @brief Converts an arcdate_t structure to a formatted HTTP Date string.
+ * @brief Parses a HTTP Date straight to Unix time.
  *
- * @param date Pointer to an arcdate_t structure.
- * @return Dynamically allocated string containing the formatted date. Must be freed by the caller.
+ * Uses the same parsing rules as parse_date() but never builds an arcdate_t or
+ * applies any offset arithmetic; the input need not be NUL-terminated.
+ *
+ * @param httpDate Pointer to the HTTP Date bytes (e.g., "Wed, 21 Oct 2015 07:28:00 GMT").
+ * @param len Number of bytes at httpDate.
+ * @return Seconds since 1970-01-01T00:00:00Z, or ARCDATE_INVALID_EPOCH if the input is not a valid HTTP Date.
  */
-char* to_date_string(const arcdate_t *date) {
-    char *buffer = (char*)malloc(100);
-    if (!buffer) return NULL;
+HTTP_DATETIME_API int64_t http_date_to_epoch(const char *httpDate, size_t len) {
+    http_fields_t f;
+    if (!httpDate || !decode_http_date(select_imf_kernel(), httpDate, len, &f)) return ARCDATE_INVALID_EPOCH;
+    return fields_to_epoch(&f);
+}
 
-    snprintf(buffer, 100, "%s, %02d %s %04d %02d:%02d:%02d GMT%+d",
-             weekday_names[date->weekday],
-             date->day,
-             month_names[date->month - 1],
-             date->year,
-             date->hour,
-             date->minute,
-             date->second,
-             date->gmt_offset);
-    return buffer;
+/* 
+ * Decodes up to nine fraction digits at s into nanoseconds; further digits are
+ * validated and truncated. Returns the number of digits consumed (0 if s[0] is
+ * not a digit).
+ */
+static size_t parse_fraction(const char *s, size_t len, int *nanosecond) {
+    static const int scale[10] = { 0, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1 };
+    int value = 0;
+    size_t n = 0;
+    while (n < len && (unsigned int)((unsigned char)s[n] - '0') <= 9) {
+        if (n < 9) value = value * 10 + (s[n] - '0');
+        n++;
+    }
+    *nanosecond = n ? value * scale[n < 9 ? n : 9] : 0;
+    return n;
 }
+
 /**
- * @brief Free an arcdate_t
+ * @brief Parses an RFC 3339 timestamp (e.g., "2015-10-21T07:28:00.123Z") into an arcdate_t.
  *
- * @param date Pointer to an arcdate_t structure to be free
- * 
+ * Accepts "T", "t" or a space between date and time, "Z"/"z" or a "+HH:MM"/"-HH:MM"
+ * offset, and a fraction of any length (nanoseconds are kept, further digits are
+ * truncated). The fields are stored as written, at the timestamp's own offset; use
+ * convert() to move them to another one. Digits are decoded with the same pair
+ * decoder as the HTTP Date parsers and nothing is allocated.
+ *
+ * @param str Pointer to the timestamp bytes (need not be NUL-terminated).
+ * @param len Number of bytes at str.
+ * @param date Pointer to the arcdate_t structure to fill.
+ * @return ARCDATE_OK on success, ARCDATE_ERR_NULL if str or date is NULL,
+ *         ARCDATE_ERR_FORMAT if the input is not a valid RFC 3339 timestamp.
  */
-void free_date(arcdate_t *date) {
-    if (date) {
-        free(date);
+HTTP_DATETIME_API arcdate_status_t parse_rfc3339(const char *str, size_t len, arcdate_t *date) {
+    if (!str || !date) return ARCDATE_ERR_NULL;
+    // "YYYY-MM-DDTHH:MM:SS" plus at least "Z"
+    if (len < 20) return ARCDATE_ERR_FORMAT;
+    if (str[4] != '-' || str[7] != '-' || (str[10] != 'T' && str[10] != 't' && str[10] != ' ') ||
+        str[13] != ':' || str[16] != ':') {
+        return ARCDATE_ERR_FORMAT;
+    }
+
+    const int century = parse_2digits(str);
+    const int year_lo = parse_2digits(str + 2);
+    const int month = parse_2digits(str + 5);
+    const int day = parse_2digits(str + 8);
+    const int hour = parse_2digits(str + 11);
+    const int minute = parse_2digits(str + 14);
+    const int second = parse_2digits(str + 17);
+    if ((century | year_lo | month | day | hour | minute | second) < 0) return ARCDATE_ERR_FORMAT;
+
+    const int year = century * 100 + year_lo;
+    if (month < 1 || month > 12 || day < 1 || day > days_in_month(month, year) ||
+        hour > 23 || minute > 59 || second > 60) {
+        return ARCDATE_ERR_FORMAT;
+    }
+
+    size_t pos = 19;
+    int nanosecond = 0;
+    if (str[pos] == '.') {
+        size_t digits = parse_fraction(str + pos + 1, len - pos - 1, &nanosecond);
+        if (digits == 0) return ARCDATE_ERR_FORMAT;
+        pos += 1 + digits;
+    }
+
+    int gmt_offset;
+    if (pos + 1 == len && (str[pos] == 'Z' || str[pos] == 'z')) {
+        gmt_offset = 0;
+    } else if (pos + 6 == len && (str[pos] == '+' || str[pos] == '-') && str[pos + 3] == ':') {
+        const int offset_hours = parse_2digits(str + pos + 1);
+        const int offset_minutes = parse_2digits(str + pos + 4);
+        if (offset_hours < 0 || offset_hours > 23 || offset_minutes < 0 || offset_minutes > 59) {
+            return ARCDATE_ERR_FORMAT;
+        }
+        gmt_offset = offset_hours * 60 + offset_minutes;
+        if (str[pos] == '-') gmt_offset = -gmt_offset;
+    } else {
+        return ARCDATE_ERR_FORMAT;
     }
+
+    date->year = year;
+    date->month = month;
+    date->day = day;
+    date->hour = hour;
+    date->minute = minute;
+    date->second = second;
+    date->weekday = weekday_from_days(days_from_civil(year, month, day));
+    date->gmt_offset = gmt_offset;
+    date->nanosecond = nanosecond;
+    return ARCDATE_OK;
+}
+
+/* 
+ * Orders a HTTP Date against a Unix time: stores -1, 0 or 1 in *order as the date is
+ * earlier than, equal to or later than mtime. The day numbers decide unless both fall
+ * on the same UTC day, so the time of day is only looked at for same-day comparisons.
+ * Returns false if the bytes are not a valid HTTP Date.
+ */
+static bool order_http_date(const char *s, size_t len, int64_t mtime, int *order) {
+    http_fields_t f;
+    if (!s || !decode_http_date(select_imf_kernel(), s, len, &f)) return false;
+
+    const int64_t mtime_day = mtime / 86400 - (mtime % 86400 < 0); // floor division
+    const int64_t day = days_from_civil(f.year, f.month, f.day);
+    if (day != mtime_day) {
+        *order = day < mtime_day ? -1 : 1;
+        return true;
+    }
+    const int64_t secs = f.hour * 3600 + f.minute * 60 + f.second;
+    const int64_t mtime_secs = mtime - mtime_day * 86400;
+    *order = (secs > mtime_secs) - (secs < mtime_secs);
+    return true;
 }
 
 /**
- * @brief Converts an arcdate_t from its current GMT offset to a new GMT offset.
+ * @brief Evaluates an If-Modified-Since precondition (RFC 9110, section 13.1.3).
  *
- * @param date Pointer to an arcdate_t structure to be updated.
- * @param new_gmt_offset The target GMT offset (e.g., +3, -5).
+ * Works on the raw header value and never builds an arcdate_t or allocates. A value
+ * that is not a valid HTTP Date is ignored, as the RFC requires.
+ *
+ * @param header Pointer to the If-Modified-Since value bytes (need not be NUL-terminated).
+ * @param len Number of bytes at header.
+ * @param mtime Last modification time of the resource, in Unix seconds.
+ * @return ARCDATE_NOT_MODIFIED (304) if the resource has not changed since the given
+ *         date, otherwise ARCDATE_PROCEED (200).
  */
-void convert(arcdate_t *date, int new_gmt_offset) {
-    int diff = new_gmt_offset - date->gmt_offset;
-    add_hours(date, diff);
-    date->gmt_offset = new_gmt_offset;
+HTTP_DATETIME_API arcdate_condition_t if_modified_since(const char *header, size_t len, int64_t mtime) {
+    int order;
+    if (!order_http_date(header, len, mtime, &order)) return ARCDATE_PROCEED;
+    return order >= 0 ? ARCDATE_NOT_MODIFIED : ARCDATE_PROCEED;
 }
 
 /**
- * @brief Adds or subtracts minutes from an arcdate_t.
+ * @brief Evaluates an If-Unmodified-Since precondition (RFC 9110, section 13.1.4).
  *
- * @param date Pointer to the arcdate_t structure to modify.
- * @param minutes Number of minutes to add (positive) or subtract (negative).
+ * Same input rules as if_modified_since(); an invalid date is ignored.
+ *
+ * @param header Pointer to the If-Unmodified-Since value bytes (need not be NUL-terminated).
+ * @param len Number of bytes at header.
+ * @param mtime Last modification time of the resource, in Unix seconds.
+ * @return ARCDATE_PRECONDITION_FAILED (412) if the resource changed after the given
+ *         date, otherwise ARCDATE_PROCEED.
  */
-void add_minutes(arcdate_t *date, int minutes) {
-    int total_minutes = date->minute + minutes;
-    int hours_change = total_minutes / 60;
-    if (total_minutes < 0) hours_change--;
+HTTP_DATETIME_API arcdate_condition_t if_unmodified_since(const char *header, size_t len, int64_t mtime) {
+    int order;
+    if (!order_http_date(header, len, mtime, &order)) return ARCDATE_PROCEED;
+    return order < 0 ? ARCDATE_PRECONDITION_FAILED : ARCDATE_PROCEED;
+}
 
-    date->minute = (total_minutes % 60 + 60) % 60;
-    add_hours(date, hours_change);
+// Inputs decoded per chunk before the column-wise conversion pass
+#define BATCH_CHUNK 64
+
+/* 
+ * Copies one chunk of a decoded column into an optional output array.
+ */
+static void store_column(int *column, size_t base, const int *chunk, size_t n) {
+    if (column) memcpy(column + base, chunk, n * sizeof(int));
 }
+
 /**
- * @brief Adds or subtracts hours from an arcdate_t.
+ * @brief Parses an array of HTTP Dates into struct-of-arrays output.
  *
- * @param date Pointer to the arcdate_t structure to modify.
- * @param hours Number of hours to add (positive) or subtract (negative).
+ * Each input is parsed with the same rules as http_date_to_epoch(). The SIMD kernel is
+ * chosen once per call, and inputs are processed in chunks: strings are decoded into
+ * column temporaries first, then Unix time is computed for the whole chunk in one
+ * branch-free loop the compiler can vectorise. Fields are UTC; no offset is applied.
+ *
+ * @param inputs Array of count (pointer, length) strings; they need not be NUL-terminated.
+ * @param count Number of inputs.
+ * @param out Output columns, each holding at least count elements. Any column may be NULL
+ *            to skip it. Entries that fail to parse get ARCDATE_INVALID_EPOCH, zeroed fields
+ *            and ARCDATE_ERR_FORMAT.
+ * @return Number of inputs parsed successfully.
  */
-void add_hours(arcdate_t *date, int hours) {
-    int total_hours = date->hour + hours;
-    int days_change = total_hours / 24;
-    if (total_hours < 0) days_change--;
+HTTP_DATETIME_API size_t parse_dates_batch(const arcdate_span_t *inputs, size_t count, const arcdate_batch_t *out) {
+    const imf_kernel_t kernel = select_imf_kernel();
+    size_t parsed = 0;
 
-    date->hour = (total_hours % 24 + 24) % 24;
-    add_days(date, days_change);
+    for (size_t base = 0; base < count; base += BATCH_CHUNK) {
+        const size_t n = count - base < BATCH_CHUNK ? count - base : BATCH_CHUNK;
+        int year[BATCH_CHUNK], month[BATCH_CHUNK], day[BATCH_CHUNK];
+        int hour[BATCH_CHUNK], minute[BATCH_CHUNK], second[BATCH_CHUNK];
+        int ok[BATCH_CHUNK];
+
+        // Pass 1: decode every string of the chunk into the column temporaries
+        for (size_t i = 0; i < n; i++) {
+            const arcdate_span_t *in = &inputs[base + i];
+            http_fields_t f;
+            ok[i] = in->ptr && decode_http_date(kernel, in->ptr, in->len, &f);
+            if (!ok[i]) memset(&f, 0, sizeof(f));
+            year[i] = f.year;
+            month[i] = f.month;
+            day[i] = f.day;
+            hour[i] = f.hour;
+            minute[i] = f.minute;
+            second[i] = f.second;
+            parsed += ok[i];
+        }
+
+        // Pass 2: days_from_civil() specialised to the non-negative years an HTTP Date can
+        // hold, shifted by one 400-year era so every term stays positive. Branch-free
+        // 32-bit arithmetic over the columns, so the compiler can vectorise it.
+        if (out->epochs) {
+            int days[BATCH_CHUNK], secs[BATCH_CHUNK];
+            for (size_t i = 0; i < n; i++) {
+                const int march = month[i] <= 2;
+                const int y = year[i] - march + 400;
+                const int mp = month[i] - 3 + 12 * march;
+                days[i] = y * 365 + y / 4 - y / 100 + y / 400 + (153 * mp + 2) / 5 + day[i] - 1
+                          - 719468 - 146097;
+                secs[i] = hour[i] * 3600 + minute[i] * 60 + second[i];
+            }
+            int64_t *epochs = out->epochs + base;
+            for (size_t i = 0; i < n; i++) {
+                epochs[i] = ok[i] ? (int64_t)days[i] * 86400 + secs[i] : ARCDATE_INVALID_EPOCH;
+            }
+        }
+
+        store_column(out->years, base, year, n);
+        store_column(out->months, base, month, n);
+        store_column(out->days, base, day, n);
+        store_column(out->hours, base, hour, n);
+        store_column(out->minutes, base, minute, n);
+        store_column(out->seconds, base, second, n);
+        if (out->status) {
+            for (size_t i = 0; i < n; i++) {
+                out->status[base + i] = ok[i] ? ARCDATE_OK : ARCDATE_ERR_FORMAT;
+            }
+        }
+    }
+    return parsed;
+}
+
+// Inputs below this size are not worth a thread of their own
+#define PARALLEL_MIN_SLICE 4096
+
+#ifdef HTTP_DATETIME_PTHREADS
+// One worker's share of a parallel batch; out columns already point at the slice
+typedef struct {
+    const arcdate_span_t *inputs;
+    size_t count;
+    arcdate_batch_t out;
+    size_t parsed;
+} batch_slice_t;
+
+static void *parse_batch_slice(void *arg) {
+    batch_slice_t *slice = (batch_slice_t *)arg;
+    slice->parsed = parse_dates_batch(slice->inputs, slice->count, &slice->out);
+    return NULL;
 }
 
+// Offsets an optional output column to the start of a slice
+#define SLICE_COLUMN(column, offset) ((column) ? (column) + (offset) : NULL)
+#endif
+
 /**
- * @brief Adds or subtracts days from an arcdate_t.
+ * @brief Parses an array of HTTP Dates on several threads.
  *
- * @param date Pointer to the arcdate_t structure to modify.
- * @param days Number of days to add (positive) or subtract (negative).
+ * Splits the input into one contiguous slice per thread and runs parse_dates_batch() on
+ * each, so every thread writes only its own range of the output columns. Slice
+ * boundaries are multiples of 64 entries, keeping threads off each other's cache lines.
+ * The calling thread parses the first slice itself. Without pthreads (or with
+ * HTTP_DATETIME_NO_THREADS) this is parse_dates_batch().
+ *
+ * @param inputs Array of count (pointer, length) strings; they need not be NUL-terminated.
+ * @param count Number of inputs.
+ * @param out Output columns, as for parse_dates_batch().
+ * @param threads Number of threads to use, or 0 for one per online CPU. Small inputs use fewer.
+ * @return Number of inputs parsed successfully.
  */
-void add_days(arcdate_t *date, int days) {
-    date->day += days;
+HTTP_DATETIME_API size_t parse_dates_batch_parallel(const arcdate_span_t *inputs, size_t count,
+                                                    const arcdate_batch_t *out, unsigned int threads) {
+#ifdef HTTP_DATETIME_PTHREADS
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (unsigned int)online : 1;
+    }
+    if (threads > count / PARALLEL_MIN_SLICE) threads = (unsigned int)(count / PARALLEL_MIN_SLICE);
+    if (threads <= 1) return parse_dates_batch(inputs, count, out);
+
+    batch_slice_t *slices = (batch_slice_t *)malloc(threads * sizeof(batch_slice_t));
+    pthread_t *workers = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    bool *started = (bool *)calloc(threads, sizeof(bool));
+    if (!slices || !workers || !started) {
+        free(slices);
+        free(workers);
+        free(started);
+        return parse_dates_batch(inputs, count, out);
+    }
+
+    size_t per_thread = (count + threads - 1) / threads;
+    per_thread = (per_thread + BATCH_CHUNK - 1) / BATCH_CHUNK * BATCH_CHUNK;
+    for (unsigned int t = 0; t < threads; t++) {
+        size_t begin = t * per_thread < count ? t * per_thread : count;
+        size_t end = begin + per_thread < count ? begin + per_thread : count;
+        batch_slice_t *slice = &slices[t];
+
+        slice->inputs = inputs + begin;
+        slice->count = end - begin;
+        slice->out.years = SLICE_COLUMN(out->years, begin);
+        slice->out.months = SLICE_COLUMN(out->months, begin);
+        slice->out.days = SLICE_COLUMN(out->days, begin);
+        slice->out.hours = SLICE_COLUMN(out->hours, begin);
+        slice->out.minutes = SLICE_COLUMN(out->minutes, begin);
+        slice->out.seconds = SLICE_COLUMN(out->seconds, begin);
+        slice->out.epochs = SLICE_COLUMN(out->epochs, begin);
+        slice->out.status = SLICE_COLUMN(out->status, begin);
+        slice->parsed = 0;
+        if (t > 0) started[t] = pthread_create(&workers[t], NULL, parse_batch_slice, slice) == 0;
+    }
 
-    while (date->day > days_in_month(date->month, date->year)) {
-        date->day -= days_in_month(date->month, date->year);
-        date->month++;
-        if (date->month > 12) {
-            date->month = 1;
-            date->year++;
+    // Slice 0 runs here, as does any slice whose thread failed to start
+    size_t parsed = 0;
+    for (unsigned int t = 0; t < threads; t++) {
+        if (started[t]) pthread_join(workers[t], NULL);
+        else parse_batch_slice(&slices[t]);
+        parsed += slices[t].parsed;
+    }
+
+    free(slices);
+    free(workers);
+    free(started);
+    return parsed;
+#else
+    (void)threads;
+    return parse_dates_batch(inputs, count, out);
+#endif
+}
+
+// A read-only view of a whole file
+typedef struct {
+    const char *data;
+    size_t size;
+    bool mapped; // true: munmap() it, false: free() it
+} file_view_t;
+
+/* 
+ * Maps path read-only into memory (or reads it into one buffer where mmap is unavailable).
+ * Returns ARCDATE_OK, ARCDATE_ERR_IO or ARCDATE_ERR_NOMEM.
+ */
+static arcdate_status_t open_file_view(const char *path, file_view_t *view) {
+    view->data = NULL;
+    view->size = 0;
+    view->mapped = false;
+#ifdef HTTP_DATETIME_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return ARCDATE_ERR_IO;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return ARCDATE_ERR_IO;
+    }
+    if (st.st_size > 0) {
+        void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return ARCDATE_ERR_IO;
         }
-        date->weekday = (date->weekday + 1) % 7;
-    }
-    
-    while (date->day < 1) {
-        date->month--;
-        if (date->month < 1) {
-            date->month = 12;
-            date->year--;
+#ifdef POSIX_MADV_SEQUENTIAL
+        posix_madvise(data, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+#endif
+        view->data = (const char *)data;
+        view->size = (size_t)st.st_size;
+        view->mapped = true;
+    }
+    close(fd);
+    return ARCDATE_OK;
+#else
+    FILE *file = fopen(path, "rb");
+    if (!file) return ARCDATE_ERR_IO;
+    if (fseek(file, 0, SEEK_END) != 0) {
+        fclose(file);
+        return ARCDATE_ERR_IO;
+    }
+    long size = ftell(file);
+    rewind(file);
+    if (size > 0) {
+        char *data = (char *)malloc((size_t)size);
+        if (!data) {
+            fclose(file);
+            return ARCDATE_ERR_NOMEM;
         }
-        date->day += days_in_month(date->month, date->year);
-        date->weekday = (date->weekday + 6) % 7; // -1 mod 7
+        if (fread(data, 1, (size_t)size, file) != (size_t)size) {
+            free(data);
+            fclose(file);
+            return ARCDATE_ERR_IO;
+        }
+        view->data = data;
+        view->size = (size_t)size;
     }
+    fclose(file);
+    return ARCDATE_OK;
+#endif
 }
-/**
- * @brief Adds or subtracts months from an arcdate_t.
- *
- * @param date Pointer to the arcdate_t structure to modify.
- * @param months Number of months to add (positive) or subtract (negative).
+
+static void close_file_view(file_view_t *view) {
+#ifdef HTTP_DATETIME_MMAP
+    if (view->mapped) munmap((void *)view->data, view->size);
+#endif
+    if (!view->mapped) free((void *)view->data);
+}
+
+/* 
+ * Locates the date field of one log line according to format.
+ * Returns false if the line has no such field.
  */
-void add_months(arcdate_t *date, int months) {
-    int total_months = date->month + months - 1;
-    int years_change = total_months / 12;
-    if (total_months < 0) years_change--;
+static bool find_log_field(const char *line, size_t len, const arcdate_log_format_t *format,
+                           const char **field, size_t *field_len) {
+    const char *end = line + len;
+    const char *start;
+    const char *stop;
 
-    date->month = (total_months % 12 + 12) % 12 + 1;
-    add_years(date, years_change);
+    if (format->open != '\0') {
+        start = (const char *)memchr(line, format->open, len);
+        if (!start) return false;
+        start++;
+        stop = (const char *)memchr(start, format->close, (size_t)(end - start));
+        if (!stop) return false;
+    } else {
+        start = line;
+        for (int column = 0; column < format->column; column++) {
+            start = (const char *)memchr(start, format->delimiter, (size_t)(end - start));
+            if (!start) return false;
+            start++;
+        }
+        stop = (const char *)memchr(start, format->delimiter, (size_t)(end - start));
+        if (!stop) stop = end;
+    }
 
-    int dim = days_in_month(date->month, date->year);
-    if (date->day > dim) date->day = dim;
+    while (start < stop && *start == ' ') start++;
+    while (stop > start && stop[-1] == ' ') stop--;
+    *field = start;
+    *field_len = (size_t)(stop - start);
+    return true;
 }
 
 /**
- * @brief Adds or subtracts years from an arcdate_t.
+ * @brief Extracts the HTTP Date of every line of a log file as Unix time.
  *
- * @param date Pointer to the arcdate_t structure to modify.
- * @param years Number of years to add (positive) or subtract (negative).
+ * The file is memory-mapped and parsed in place: lines are found with memchr, the
+ * date field is located as described by format and decoded without copying, so no
+ * per-line allocation or stdio buffering is involved. The only allocation is the
+ * result array, sized by a first newline-counting pass.
+ *
+ * @param path Path of the log file.
+ * @param format Where the date sits on each line: between the first format->open and the
+ *               following format->close (e.g. '[' and ']'), or, when open is '\0', in
+ *               zero-based column format->column of format->delimiter-separated fields.
+ *               Spaces around the field are ignored; a trailing '\r' is stripped.
+ * @param epochs Receives a malloc'ed array with one entry per line (ARCDATE_INVALID_EPOCH for
+ *               lines without a valid HTTP Date), or NULL for an empty file. Free with free().
+ * @param count Receives the number of lines.
+ * @return ARCDATE_OK, ARCDATE_ERR_NULL, ARCDATE_ERR_IO if the file cannot be read, or
+ *         ARCDATE_ERR_NOMEM.
  */
-void add_years(arcdate_t *date, int years) {
-    date->year += years;
-    if (date->month == 2 && date->day == 29 && !is_leap_year(date->year)) {
-        date->day = 28;
+HTTP_DATETIME_API arcdate_status_t extract_log_dates(const char *path, const arcdate_log_format_t *format,
+                                                     int64_t **epochs, size_t *count) {
+    if (!path || !format || !epochs || !count) return ARCDATE_ERR_NULL;
+    *epochs = NULL;
+    *count = 0;
+
+    file_view_t view;
+    arcdate_status_t status = open_file_view(path, &view);
+    if (status != ARCDATE_OK) return status;
+
+    const char *data = view.data;
+    const char *end = data + view.size;
+    size_t lines = 0;
+    for (const char *p = data; p < end; lines++) {
+        const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+        p = nl ? nl + 1 : end;
     }
+    if (lines == 0) {
+        close_file_view(&view);
+        return ARCDATE_OK;
+    }
+
+    int64_t *out = (int64_t *)malloc(lines * sizeof(int64_t));
+    if (!out) {
+        close_file_view(&view);
+        return ARCDATE_ERR_NOMEM;
+    }
+
+    const imf_kernel_t kernel = select_imf_kernel();
+    size_t n = 0;
+    for (const char *p = data; p < end; n++) {
+        const char *nl = (const char *)memchr(p, '\n', (size_t)(end - p));
+        const char *line_end = nl ? nl : end;
+        size_t len = (size_t)(line_end - p);
+        if (len > 0 && p[len - 1] == '\r') len--;
+
+        const char *field;
+        size_t field_len;
+        http_fields_t f;
+        out[n] = find_log_field(p, len, format, &field, &field_len) &&
+                 decode_http_date(kernel, field, field_len, &f)
+                     ? fields_to_epoch(&f)
+                     : ARCDATE_INVALID_EPOCH;
+        p = nl ? nl + 1 : end;
+    }
+
+    close_file_view(&view);
+    *epochs = out;
+    *count = n;
+    return ARCDATE_OK;
+}
+
+/**
+ * @brief Generates an arcdate_t object from a HTTP Date string or system time.
+ *
+ * Thin allocating wrapper around parse_date().
+ *
+ * @param httpDate A HTTP Date string (e.g., "Wed, 21 Oct 2015 07:28:00 GMT"), or NULL for current system UTC time.
+ * @param gmt_offset Desired GMT offset to apply, in minutes (e.g., 0, +180, -300, +330).
+ * @return Pointer to a dynamically allocated arcdate_t structure, or NULL if allocation
+ *         or parsing fails. Must be freed using free_date().
+ */
+HTTP_DATETIME_API arcdate_t* generate_date(const char *httpDate, int gmt_offset) {
+    arcdate_t *date = (arcdate_t*)malloc(sizeof(arcdate_t));
+    if (!date) return NULL;
+
+    if (parse_date(httpDate, gmt_offset, date) != ARCDATE_OK) {
+        free(date);
+        return NULL;
+    }
+    return date;
+}
+// "00" .. "99", indexed by 2 * value
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/* 
+ * Writes v (0-99) as two ASCII digits.
+ */
+static void write_2digits(char *p, int v) {
+    memcpy(p, digit_pairs + 2 * v, 2);
+}
+
+/* 
+ * Writes v like printf's "%0<width>d" (or "%+d" when force_sign is set, with width 0)
+ * and returns the number of bytes written. Two-digit values use the pair table.
+ */
+static int write_int(char *p, int v, int width, bool force_sign) {
+    char digits[12];
+    int n = 0;
+    int len = 0;
+    unsigned int u = v < 0 ? 0u - (unsigned int)v : (unsigned int)v;
+
+    if (v < 0) p[len++] = '-';
+    else if (force_sign) p[len++] = '+';
+
+    do {
+        digits[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+    while (len + n < width) p[len++] = '0';
+    while (n) p[len++] = digits[--n];
+    return len;
+}
+
+/* 
+ * Writes a "%02d" field, taking the table path for the usual 0-99 range.
+ */
+static int write_field2(char *p, int v) {
+    if (v >= 0 && v <= 99) {
+        write_2digits(p, v);
+        return 2;
+    }
+    return write_int(p, v, 2, false);
+}
+
+/**
+ * @brief Formats an arcdate_t into a caller-supplied buffer.
+ *
+ * Produces exactly the same bytes as to_date_string() (e.g., "Wed, 21 Oct 2015 10:28:00 GMT+3",
+ * or "Wed, 21 Oct 2015 12:58:00 GMT+5:30" for an offset that is not a whole hour)
+ * without heap allocation or snprintf. The nanosecond field is not printed; use
+ * to_rfc3339_buf() for sub-second output. A buffer of ARCDATE_STRING_MAX bytes always suffices.
+ *
+ * @param date Pointer to an arcdate_t structure.
+ * @param buf Destination buffer; NUL-terminated on success.
+ * @param size Size of buf in bytes.
+ * @return Number of bytes written, excluding the terminating NUL, or 0 if buf is too small
+ *         (buf then holds an empty string when size > 0).
+ */
+HTTP_DATETIME_API size_t to_date_string_buf(const arcdate_t *date, char *buf, size_t size) {
+    char tmp[ARCDATE_STRING_MAX];
+    char *p = tmp;
+
+    memcpy(p, weekday_names[date->weekday], 3);
+    memcpy(p + 3, ", ", 2);
+    p += 5;
+    p += write_field2(p, date->day);
+    *p++ = ' ';
+    memcpy(p, month_names[date->month - 1], 3);
+    p[3] = ' ';
+    p += 4;
+    if (date->year >= 0 && date->year <= 9999) {
+        write_2digits(p, date->year / 100);
+        write_2digits(p + 2, date->year % 100);
+        p += 4;
+    } else {
+        p += write_int(p, date->year, 4, false);
+    }
+    *p++ = ' ';
+    p += write_field2(p, date->hour);
+    *p++ = ':';
+    p += write_field2(p, date->minute);
+    *p++ = ':';
+    p += write_field2(p, date->second);
+    memcpy(p, " GMT", 4);
+    p += 4;
+    // "+3" for whole hours, "+5:30" otherwise
+    const int offset = date->gmt_offset < 0 ? -date->gmt_offset : date->gmt_offset;
+    *p++ = date->gmt_offset < 0 ? '-' : '+';
+    p += write_int(p, offset / 60, 0, false);
+    if (offset % 60 != 0) {
+        *p++ = ':';
+        write_2digits(p, offset % 60);
+        p += 2;
+    }
+
+    size_t len = (size_t)(p - tmp);
+    if (len >= size) {
+        if (size > 0) buf[0] = '\0';
+        return 0;
+    }
+    memcpy(buf, tmp, len);
+    buf[len] = '\0';
+    return len;
+}
+
+/**
+ * @brief Converts an arcdate_t structure to a formatted HTTP Date string.
+ *
+ * @param date Pointer to an arcdate_t structure.
+ * @return Dynamically allocated string containing the formatted date. Must be freed by the caller.
+ */
+HTTP_DATETIME_API char* to_date_string(const arcdate_t *date) {
+    char *buffer = (char*)malloc(ARCDATE_STRING_MAX);
+    if (!buffer) return NULL;
+
+    to_date_string_buf(date, buffer, ARCDATE_STRING_MAX);
+    return buffer;
+}
+/**
+ * @brief Formats an arcdate_t as an RFC 3339 timestamp in a caller-supplied buffer.
+ *
+ * Writes the fields at the date's own offset, e.g. "2015-10-21T10:28:00+03:00", or
+ * "2015-10-21T07:28:00Z" at offset 0. A non-zero nanosecond field is written as a
+ * fraction of 3, 6 or 9 digits, whichever is the shortest exact one.
+ *
+ * @param date Pointer to an arcdate_t structure.
+ * @param buf Destination buffer; NUL-terminated on success.
+ * @param size Size of buf in bytes; ARCDATE_RFC3339_MAX always suffices.
+ * @return Number of bytes written, excluding the terminating NUL, or 0 if buf is too small,
+ *         the year is outside 0-9999, another field is outside its range (month 1-12,
+ *         day 1-31, hour 0-23, minute 0-59, second 0-60), the offset is beyond +/-23:59
+ *         or the nanosecond field is outside 0-999999999 (buf then holds an empty
+ *         string when size > 0).
+ */
+HTTP_DATETIME_API size_t to_rfc3339_buf(const arcdate_t *date, char *buf, size_t size) {
+    char tmp[ARCDATE_RFC3339_MAX];
+    char *p = tmp;
+
+    // Every field below must fit its fixed width, or tmp could overflow
+    if (date->year < 0 || date->year > 9999 || date->month < 1 || date->month > 12 ||
+        date->day < 1 || date->day > 31 || date->hour < 0 || date->hour > 23 ||
+        date->minute < 0 || date->minute > 59 || date->second < 0 || date->second > 60 ||
+        date->gmt_offset < -(23 * 60 + 59) || date->gmt_offset > 23 * 60 + 59 ||
+        date->nanosecond < 0 || date->nanosecond > 999999999) {
+        if (size > 0) buf[0] = '\0';
+        return 0;
+    }
+    write_2digits(p, date->year / 100);
+    write_2digits(p + 2, date->year % 100);
+    p[4] = '-';
+    write_2digits(p + 5, date->month);
+    p[7] = '-';
+    write_2digits(p + 8, date->day);
+    p[10] = 'T';
+    write_2digits(p + 11, date->hour);
+    p[13] = ':';
+    write_2digits(p + 14, date->minute);
+    p[16] = ':';
+    write_2digits(p + 17, date->second);
+    p += 19;
+
+    if (date->nanosecond != 0) {
+        int fraction = date->nanosecond;
+        int width = 9;
+        while (width > 3 && fraction % 1000 == 0) {
+            fraction /= 1000;
+            width -= 3;
+        }
+        *p++ = '.';
+        p += write_int(p, fraction, width, false);
+    }
+
+    if (date->gmt_offset == 0) {
+        *p++ = 'Z';
+    } else {
+        const int offset = date->gmt_offset < 0 ? -date->gmt_offset : date->gmt_offset;
+        *p++ = date->gmt_offset < 0 ? '-' : '+';
+        p += write_field2(p, offset / 60);
+        *p++ = ':';
+        write_2digits(p, offset % 60);
+        p += 2;
+    }
+
+    size_t len = (size_t)(p - tmp);
+    if (len >= size) {
+        if (size > 0) buf[0] = '\0';
+        return 0;
+    }
+    memcpy(buf, tmp, len);
+    buf[len] = '\0';
+    return len;
+}
+
+/* 
+ * Writes the UTC fields of date as an IMF-fixdate: exactly ARCDATE_IMF_FIXDATE_LEN
+ * bytes, no NUL. The year must be within 0-9999.
+ */
+static void format_imf_fixdate(const arcdate_t *date, char *out) {
+    memcpy(out, weekday_names[date->weekday], 3);
+    memcpy(out + 3, ", ", 2);
+    write_2digits(out + 5, date->day);
+    out[7] = ' ';
+    memcpy(out + 8, month_names[date->month - 1], 3);
+    out[11] = ' ';
+    write_2digits(out + 12, date->year / 100);
+    write_2digits(out + 14, date->year % 100);
+    out[16] = ' ';
+    write_2digits(out + 17, date->hour);
+    out[19] = ':';
+    write_2digits(out + 20, date->minute);
+    out[22] = ':';
+    write_2digits(out + 23, date->second);
+    memcpy(out + 25, " GMT", 4);
+}
+
+/**
+ * @brief Formats an arcdate_t as an RFC 7231 IMF-fixdate, normalised to UTC.
+ *
+ * Always writes exactly ARCDATE_IMF_FIXDATE_LEN (29) bytes such as
+ * "Sun, 06 Nov 1994 08:49:37 GMT", whatever the date's gmt_offset, so header space
+ * can be reserved up front. No NUL terminator is written.
+ *
+ * @param date Pointer to an arcdate_t structure.
+ * @param buf Destination with room for at least ARCDATE_IMF_FIXDATE_LEN bytes.
+ * @return ARCDATE_IMF_FIXDATE_LEN, or 0 (nothing written) if the UTC year is outside 0-9999
+ *         and so cannot be expressed as an IMF-fixdate.
+ */
+HTTP_DATETIME_API size_t to_imf_fixdate(const arcdate_t *date, char *buf) {
+    arcdate_t utc;
+    epoch_to_date(date_to_epoch(date), 0, &utc);
+    if (utc.year < 0 || utc.year > 9999) return 0;
+
+    format_imf_fixdate(&utc, buf);
+    return ARCDATE_IMF_FIXDATE_LEN;
+}
+
+// One formatted Date header value and the second it describes
+typedef struct {
+    int64_t second;
+    char text[ARCDATE_IMF_FIXDATE_LEN + 1];
+} date_cache_slot_t;
+
+// Slots are reused round-robin, so a returned string stays intact for this many regenerations
+#define DATE_CACHE_SLOTS 64
+
+static date_cache_slot_t date_cache[DATE_CACHE_SLOTS];
+static date_cache_slot_t *date_cache_current = NULL;
+static unsigned int date_cache_next = 0;
+static bool date_cache_lock = false;
+
+/**
+ * @brief Forces the IMF-fixdate kernel used by every parser, e.g. to benchmark or
+ *        test one kernel against another.
+ *
+ * Every kernel accepts exactly the same inputs. May be called at any time from any
+ * thread; parses already running finish with the kernel they started with.
+ *
+ * @param kernel Kernel to use, or ARCDATE_KERNEL_AUTO (the default) for the fastest
+ *        one the CPU supports.
+ * @return true on success, false if that kernel is not compiled in or the CPU lacks
+ *         its instructions (the current choice is then kept).
+ */
+HTTP_DATETIME_API bool set_imf_kernel(arcdate_kernel_t kernel) {
+    if (!imf_kernel_for(kernel)) return false;
+    ATOMIC_STORE_RELEASE(&imf_kernel_choice, kernel);
+    return true;
+}
+
+/**
+ * @brief Switches the current-time path to the coarse clock.
+ *
+ * When enabled, parse_date(NULL, ...), generate_date(NULL, ...) and http_date_now()
+ * read CLOCK_REALTIME_COARSE where the platform has it, and parse_date() reuses the
+ * calling thread's last decomposition while the second and offset are unchanged, so
+ * a "now" call is a clock read and a compare. The coarse clock advances once per
+ * kernel tick (typically 1-4 ms), so a new second may be seen that much late.
+ * Off by default; may be toggled at any time from any thread.
+ *
+ * @param enabled true to use the coarse clock, false for CLOCK_REALTIME.
+ */
+HTTP_DATETIME_API void set_coarse_clock(bool enabled) {
+    ATOMIC_STORE_RELEASE(&coarse_clock, enabled);
+}
+
+/**
+ * @brief Returns the current time as an IMF-fixdate for a Date response header.
+ *
+ * The string is regenerated at most once per wall-clock second and never moves
+ * backwards; every other call is a clock read and a compare. Safe to call from any number of threads: readers never
+ * block, one caller refreshes the cache while the others keep returning the previous
+ * second. The returned buffer is immutable and remains valid for at least
+ * DATE_CACHE_SLOTS (64) further regenerations, i.e. about a minute.
+ *
+ * @return Pointer to a NUL-terminated 29-byte string such as "Sun, 06 Nov 1994 08:49:37 GMT".
+ *         Must not be freed.
+ */
+HTTP_DATETIME_API const char* http_date_now(void) {
+    const int64_t now = read_wall_clock(NULL);
+    date_cache_slot_t *slot = ATOMIC_LOAD_ACQUIRE(&date_cache_current);
+    // A clock read from just before the last refresh (or a coarse read mixed with a
+    // precise one) must not republish an older second
+    if (slot && now <= slot->second) return slot->text;
+
+    if (!ATOMIC_TRY_LOCK(&date_cache_lock)) {
+        if (slot) return slot->text; // another thread is refreshing; one second stale at most
+        while (!ATOMIC_TRY_LOCK(&date_cache_lock)) { }
+        slot = ATOMIC_LOAD_ACQUIRE(&date_cache_current);
+        if (slot) {
+            ATOMIC_UNLOCK(&date_cache_lock);
+            return slot->text;
+        }
+    }
+    // Another thread may have published this second while we took the lock
+    slot = ATOMIC_LOAD_ACQUIRE(&date_cache_current);
+    if (slot && now <= slot->second) {
+        ATOMIC_UNLOCK(&date_cache_lock);
+        return slot->text;
+    }
+
+    date_cache_slot_t *next = &date_cache[date_cache_next];
+    date_cache_next = (date_cache_next + 1) % DATE_CACHE_SLOTS;
+
+    arcdate_t date;
+    epoch_to_date(now, 0, &date);
+    format_imf_fixdate(&date, next->text);
+    next->text[ARCDATE_IMF_FIXDATE_LEN] = '\0';
+    next->second = now;
+
+    ATOMIC_STORE_RELEASE(&date_cache_current, next);
+    ATOMIC_UNLOCK(&date_cache_lock);
+    return next->text;
+}
+
+/**
+ * @brief Free an arcdate_t
+ *
+ * @param date Pointer to an arcdate_t structure to be free
+ * 
+ */
+HTTP_DATETIME_API void free_date(arcdate_t *date) {
+    if (date) {
+        free(date);
+    }
+}
+
+/**
+ * @brief Converts an arcdate_t from its current GMT offset to a new GMT offset.
+ *
+ * @param date Pointer to an arcdate_t structure to be updated.
+ * @param new_gmt_offset The target GMT offset in minutes (e.g., +180, -300, +345).
+ */
+HTTP_DATETIME_API void convert(arcdate_t *date, int new_gmt_offset) {
+    int diff = new_gmt_offset - date->gmt_offset;
+    add_minutes(date, diff);
+    date->gmt_offset = new_gmt_offset;
+}
+
+/**
+ * @brief Adds or subtracts minutes from an arcdate_t.
+ *
+ * @param date Pointer to the arcdate_t structure to modify.
+ * @param minutes Number of minutes to add (positive) or subtract (negative).
+ */
+HTTP_DATETIME_API void add_minutes(arcdate_t *date, int minutes) {
+    int total_minutes = date->minute + minutes;
+    int hours_change = total_minutes / 60;
+    if (total_minutes % 60 < 0) hours_change--;
+
+    date->minute = (total_minutes % 60 + 60) % 60;
+    add_hours(date, hours_change);
+}
+/**
+ * @brief Adds or subtracts hours from an arcdate_t.
+ *
+ * @param date Pointer to the arcdate_t structure to modify.
+ * @param hours Number of hours to add (positive) or subtract (negative).
+ */
+HTTP_DATETIME_API void add_hours(arcdate_t *date, int hours) {
+    int total_hours = date->hour + hours;
+    int days_change = total_hours / 24;
+    if (total_hours % 24 < 0) days_change--;
+
+    date->hour = (total_hours % 24 + 24) % 24;
+    add_days(date, days_change);
+}
+
+/**
+ * @brief Adds or subtracts days from an arcdate_t.
+ *
+ * Runs in constant time regardless of the delta; the weekday is recomputed from the result.
+ *
+ * @param date Pointer to the arcdate_t structure to modify.
+ * @param days Number of days to add (positive) or subtract (negative).
+ */
+HTTP_DATETIME_API void add_days(arcdate_t *date, int days) {
+    int64_t serial = days_from_civil(date->year, date->month, date->day) + days;
+    civil_from_days(serial, date);
+}
+/**
+ * @brief Converts an arcdate_t to Unix time.
+ *
+ * The broken-down fields are interpreted as local time at date->gmt_offset,
+ * so the result is the same instant whichever offset the date is expressed in.
+ * Runs in constant time with no libc calls. The nanosecond field is not included.
+ *
+ * @param date Pointer to an arcdate_t structure.
+ * @return Seconds since 1970-01-01T00:00:00Z (negative before the epoch).
+ */
+HTTP_DATETIME_API int64_t date_to_epoch(const arcdate_t *date) {
+    return days_from_civil(date->year, date->month, date->day) * 86400 +
+           date->hour * 3600 + date->minute * 60 + date->second -
+           (int64_t)date->gmt_offset * 60;
+}
+
+/**
+ * @brief Fills an arcdate_t from Unix time, expressed at the given GMT offset.
+ *
+ * Runs in constant time with no libc calls (no gmtime/timegm round trip).
+ * The nanosecond field is set to 0.
+ *
+ * @param epoch Seconds since 1970-01-01T00:00:00Z.
+ * @param gmt_offset GMT offset of the result in minutes (e.g., 0, +180, -300).
+ * @param date Pointer to the arcdate_t structure to fill.
+ */
+HTTP_DATETIME_API void epoch_to_date(int64_t epoch, int gmt_offset, arcdate_t *date) {
+    const int64_t local = epoch + (int64_t)gmt_offset * 60;
+    const int64_t days = local / 86400 - (local % 86400 < 0); // floor division
+    const int secs = (int)(local - days * 86400);
+
+    civil_from_days(days, date);
+    date->hour = secs / 3600;
+    date->minute = secs / 60 % 60;
+    date->second = secs % 60;
+    date->gmt_offset = gmt_offset;
+    date->nanosecond = 0;
+}
+
+/**
+ * @brief Compares the instants described by two arcdate_t values.
+ *
+ * Each date is read at its own gmt_offset, so "10:00 GMT+3" equals "07:00 GMT+0";
+ * nanoseconds break ties within a second. Constant time; neither date is modified
+ * or copied.
+ *
+ * @param a Pointer to the first arcdate_t.
+ * @param b Pointer to the second arcdate_t.
+ * @return Negative if a is earlier than b, 0 if they are the same instant, positive if later.
+ */
+HTTP_DATETIME_API int compare_dates(const arcdate_t *a, const arcdate_t *b) {
+    const int64_t ea = date_to_epoch(a), eb = date_to_epoch(b);
+    if (ea != eb) return ea < eb ? -1 : 1;
+    return (a->nanosecond > b->nanosecond) - (a->nanosecond < b->nanosecond);
+}
+
+/**
+ * @brief Returns the number of seconds from b to a.
+ *
+ * Offset-aware like compare_dates(): the result is the same whichever offsets the
+ * two dates are expressed in. Nanosecond fields are ignored.
+ *
+ * @param a Pointer to the later (minuend) arcdate_t.
+ * @param b Pointer to the earlier (subtrahend) arcdate_t.
+ * @return a - b in seconds; negative when a is earlier than b.
+ */
+HTTP_DATETIME_API int64_t diff_seconds(const arcdate_t *a, const arcdate_t *b) {
+    return date_to_epoch(a) - date_to_epoch(b);
+}
+
+/*
+ * Packed layout, most significant first: year + 2^25 (26 bits), month (4), day (5),
+ * hour (5), minute (6), second (6), then gmt_offset + 2048 (12). The date fields are
+ * the UTC instant, so unsigned order is chronological order; equal instants order
+ * by offset. Month is never 0, so 0 is free for ARCDATE_PACKED_INVALID.
+ */
+#define PACKED_YEAR_BIAS (1 << 25)
+#define PACKED_OFFSET_BIAS 2048
+
+/**
+ * @brief Packs an arcdate_t into 64 bits.
+ *
+ * The result compares with a single integer compare: a < b exactly when a is the
+ * earlier instant (ties broken by GMT offset). unpack_date() restores every field,
+ * weekday included, for any date this accepts, a leap second (second 60) included;
+ * the layout has no room for the nanosecond field, which is dropped and comes back as 0.
+ *
+ * @param date Pointer to the arcdate_t to pack.
+ * @return Packed value, or ARCDATE_PACKED_INVALID if date is NULL, a field is out of
+ *         range (second may be 60), its UTC year is outside +/-2^25 or its offset
+ *         outside [-2048, 2047] minutes.
+ */
+HTTP_DATETIME_API arcdate_packed_t pack_date(const arcdate_t *date) {
+    if (!date) return ARCDATE_PACKED_INVALID;
+    if (date->gmt_offset < -PACKED_OFFSET_BIAS || date->gmt_offset >= PACKED_OFFSET_BIAS) {
+        return ARCDATE_PACKED_INVALID;
+    }
+    if (date->month < 1 || date->month > 12 || date->day < 1 ||
+        date->day > days_in_month(date->month, date->year) || date->hour < 0 || date->hour > 23 ||
+        date->minute < 0 || date->minute > 59 || date->second < 0 || date->second > 60) {
+        return ARCDATE_PACKED_INVALID;
+    }
+
+    arcdate_t utc = *date;
+    if (date->gmt_offset != 0) {
+        // Offsets are whole minutes, so a leap second stays second 60 of the UTC minute
+        utc.second = date->second == 60 ? 59 : date->second;
+        epoch_to_date(date_to_epoch(&utc), 0, &utc);
+        utc.second = date->second;
+    }
+    if (utc.year < -PACKED_YEAR_BIAS || utc.year >= PACKED_YEAR_BIAS) return ARCDATE_PACKED_INVALID;
+
+    return (uint64_t)(utc.year + PACKED_YEAR_BIAS) << 38 |
+           (uint64_t)utc.month << 34 |
+           (uint64_t)utc.day << 29 |
+           (uint64_t)utc.hour << 24 |
+           (uint64_t)utc.minute << 18 |
+           (uint64_t)utc.second << 12 |
+           (uint64_t)(date->gmt_offset + PACKED_OFFSET_BIAS);
+}
+
+/**
+ * @brief Restores an arcdate_t from pack_date() output.
+ *
+ * @param packed Value returned by pack_date().
+ * @param date Pointer to the arcdate_t structure to fill.
+ * @return ARCDATE_OK on success, ARCDATE_ERR_NULL if date is NULL,
+ *         ARCDATE_ERR_FORMAT if packed holds an impossible date.
+ */
+HTTP_DATETIME_API arcdate_status_t unpack_date(arcdate_packed_t packed, arcdate_t *date) {
+    if (!date) return ARCDATE_ERR_NULL;
+
+    arcdate_t utc;
+    utc.year = (int)(packed >> 38) - PACKED_YEAR_BIAS;
+    utc.month = (int)(packed >> 34 & 0xF);
+    utc.day = (int)(packed >> 29 & 0x1F);
+    utc.hour = (int)(packed >> 24 & 0x1F);
+    utc.minute = (int)(packed >> 18 & 0x3F);
+    utc.second = (int)(packed >> 12 & 0x3F);
+    utc.gmt_offset = 0;
+    utc.nanosecond = 0;
+    const int gmt_offset = (int)(packed & 0xFFF) - PACKED_OFFSET_BIAS;
+
+    if (utc.month < 1 || utc.month > 12 || utc.day < 1 || utc.day > days_in_month(utc.month, utc.year) ||
+        utc.hour > 23 || utc.minute > 59 || utc.second > 60) {
+        return ARCDATE_ERR_FORMAT;
+    }
+
+    if (gmt_offset == 0) {
+        utc.weekday = weekday_from_days(days_from_civil(utc.year, utc.month, utc.day));
+        *date = utc;
+    } else {
+        const int second = utc.second;
+        utc.second = second == 60 ? 59 : second;
+        epoch_to_date(date_to_epoch(&utc), gmt_offset, date);
+        date->second = second;
+    }
+    return ARCDATE_OK;
+}
+
+/**
+ * @brief Adds or subtracts months from an arcdate_t.
+ *
+ * @param date Pointer to the arcdate_t structure to modify.
+ * @param months Number of months to add (positive) or subtract (negative).
+ */
+HTTP_DATETIME_API void add_months(arcdate_t *date, int months) {
+    int total_months = date->month + months - 1;
+    int years_change = total_months / 12;
+    if (total_months % 12 < 0) years_change--;
+
+    date->month = (total_months % 12 + 12) % 12 + 1;
+    add_years(date, years_change);
+
+    int dim = days_in_month(date->month, date->year);
+    if (date->day > dim) date->day = dim;
+    date->weekday = weekday_from_days(days_from_civil(date->year, date->month, date->day));
+}
+
+/**
+ * @brief Adds or subtracts years from an arcdate_t.
+ *
+ * @param date Pointer to the arcdate_t structure to modify.
+ * @param years Number of years to add (positive) or subtract (negative).
+ */
+HTTP_DATETIME_API void add_years(arcdate_t *date, int years) {
+    date->year += years;
+    if (date->month == 2 && date->day == 29 && !is_leap_year(date->year)) {
+        date->day = 28;
+    }
+    date->weekday = weekday_from_days(days_from_civil(date->year, date->month, date->day));
+}
+
+/**
+ * @brief Adds or subtracts seconds from an arcdate_t.
+ *
+ * Constant time for any delta; the offset and nanosecond fields are kept.
+ *
+ * @param date Pointer to the arcdate_t structure to modify.
+ * @param seconds Number of seconds to add (positive) or subtract (negative).
+ */
+HTTP_DATETIME_API void add_seconds(arcdate_t *date, int64_t seconds) {
+    const int nanosecond = date->nanosecond;
+    epoch_to_date(date_to_epoch(date) + seconds, date->gmt_offset, date);
+    date->nanosecond = nanosecond;
+}
+
+/**
+ * @brief Adds or subtracts nanoseconds from an arcdate_t, carrying into the seconds.
+ *
+ * @param date Pointer to the arcdate_t structure to modify.
+ * @param nanoseconds Number of nanoseconds to add (positive) or subtract (negative).
+ */
+HTTP_DATETIME_API void add_nanoseconds(arcdate_t *date, int64_t nanoseconds) {
+    const int64_t total = date->nanosecond + nanoseconds % 1000000000;
+    int64_t carry = nanoseconds / 1000000000 + total / 1000000000;
+    int64_t rest = total % 1000000000;
+    if (rest < 0) {
+        rest += 1000000000;
+        carry--;
+    }
+    date->nanosecond = (int)rest;
+    if (carry != 0) add_seconds(date, carry);
+}
+
+/*
+ * Time zones. A zone is a sorted table of UTC transition instants, each with the
+ * offset that applies from then on, plus an optional POSIX TZ rule (for example
+ * "CET-1CEST,M3.5.0,M10.5.0/3") that covers instants outside the table. Embedded
+ * zones are stored as rule strings and compiled into a 1970-2100 table the first
+ * time they are looked up, so a conversion is one binary search over at most 262
+ * entries; years outside the table are evaluated from the rule directly.
+ */
+
+// One end of a POSIX TZ daylight-saving period
+typedef struct {
+    char kind;          // 'M' (Mm.w.d), 'J' (Jn, no leap day) or 'D' (n, zero-based)
+    int month, week, weekday;
+    int day;            // J and D forms
+    int time;           // seconds after local midnight; may be negative or past 24h
+} tz_rule_date_t;
+
+// A parsed POSIX TZ string
+typedef struct {
+    int32_t std_offset; // seconds east of UTC
+    int32_t dst_offset;
+    bool has_dst;
+    tz_rule_date_t start, end;
+} tz_rule_t;
+
+struct arcdate_zone {
+    const char *name;
+    const int64_t *at;      // UTC transition instants, ascending
+    const int32_t *offset;  // seconds east of UTC from at[i] on
+    size_t count;
+    int32_t initial;        // offset before at[0], or always when count is 0
+    bool has_rule;          // rule applies from at[count - 1] on
+    bool rule_before;       // rule also applies before at[0]
+    tz_rule_t rule;
+    int64_t valid_from;     // earliest instant the zone knows, or INT64_MIN
+};
+
+// Years covered by the compiled table of an embedded zone
+#define TZ_TABLE_FIRST_YEAR 1970
+#define TZ_TABLE_LAST_YEAR 2100
+
+/* 
+ * Skips a POSIX TZ zone abbreviation: three or more letters, or any text in <>.
+ * Returns the byte after it, or NULL if there is none.
+ */
+static const char *skip_tz_name(const char *p) {
+    const char *start = p;
+    if (*p == '<') {
+        while (*p && *p != '>') p++;
+        return *p == '>' ? p + 1 : NULL;
+    }
+    while ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z')) p++;
+    return p - start >= 3 ? p : NULL;
+}
+
+/* 
+ * Parses "[+-]hh[:mm[:ss]]" into seconds, with hours up to max_hours.
+ * Returns the byte after it, or NULL if malformed.
+ */
+static const char *parse_tz_time(const char *p, int max_hours, int *seconds) {
+    int sign = 1;
+    if (*p == '+' || *p == '-') sign = *p++ == '-' ? -1 : 1;
+
+    int parts[3] = { 0, 0, 0 };
+    for (int i = 0; i < 3; i++) {
+        if (i > 0) {
+            if (*p != ':') break;
+            p++;
+        }
+        int digits = 0;
+        while (*p >= '0' && *p <= '9' && digits < 3) {
+            parts[i] = parts[i] * 10 + (*p++ - '0');
+            digits++;
+        }
+        if (digits == 0 || (i > 0 && (digits != 2 || parts[i] > 59))) return NULL;
+    }
+    if (parts[0] > max_hours) return NULL;
+    *seconds = sign * (parts[0] * 3600 + parts[1] * 60 + parts[2]);
+    return p;
+}
+
+/* 
+ * Parses an unsigned decimal in [min, max]. Returns the byte after it, or NULL.
+ */
+static const char *parse_tz_number(const char *p, int min, int max, int *value) {
+    int v = 0, digits = 0;
+    while (*p >= '0' && *p <= '9' && digits < 4) {
+        v = v * 10 + (*p++ - '0');
+        digits++;
+    }
+    if (digits == 0 || v < min || v > max) return NULL;
+    *value = v;
+    return p;
+}
+
+/* 
+ * Parses ",Mm.w.d[/time]", ",Jn[/time]" or ",n[/time]".
+ */
+static const char *parse_tz_rule_date(const char *p, tz_rule_date_t *date) {
+    if (*p++ != ',') return NULL;
+    if (*p == 'M') {
+        date->kind = 'M';
+        p = parse_tz_number(p + 1, 1, 12, &date->month);
+        if (!p || *p++ != '.') return NULL;
+        p = parse_tz_number(p, 1, 5, &date->week);
+        if (!p || *p++ != '.') return NULL;
+        p = parse_tz_number(p, 0, 6, &date->weekday);
+    } else if (*p == 'J') {
+        date->kind = 'J';
+        p = parse_tz_number(p + 1, 1, 365, &date->day);
+    } else {
+        date->kind = 'D';
+        p = parse_tz_number(p, 0, 365, &date->day);
+    }
+    if (!p) return NULL;
+
+    date->time = 7200; // 02:00 local unless given
+    if (*p == '/') p = parse_tz_time(p + 1, 167, &date->time);
+    return p;
+}
+
+/* 
+ * Parses a POSIX TZ string such as "EST5EDT,M3.2.0,M11.1.0" or "IST-5:30".
+ * POSIX offsets count west of UTC; they are stored east of UTC.
+ */
+static bool parse_tz_rule(const char *p, tz_rule_t *rule) {
+    int seconds;
+    memset(rule, 0, sizeof(*rule));
+    if (!(p = skip_tz_name(p)) || !(p = parse_tz_time(p, 24, &seconds))) return false;
+    rule->std_offset = -seconds;
+    if (*p == '\0') return true;
+
+    if (!(p = skip_tz_name(p))) return false;
+    rule->has_dst = true;
+    rule->dst_offset = rule->std_offset + 3600;
+    if (*p != ',' && *p != '\0') {
+        if (!(p = parse_tz_time(p, 24, &seconds))) return false;
+        rule->dst_offset = -seconds;
+    }
+    // "EST5EDT" without dates: the POSIX default is US rules
+    if (*p == '\0') p = ",M3.2.0,M11.1.0";
+    if (!(p = parse_tz_rule_date(p, &rule->start)) || !(p = parse_tz_rule_date(p, &rule->end))) return false;
+    return *p == '\0';
+}
+
+/* 
+ * Returns the local day number (days since 1970-01-01) a rule date falls on in year.
+ */
+static int64_t tz_rule_day(const tz_rule_date_t *date, int year) {
+    const int64_t jan1 = days_from_civil(year, 1, 1);
+    if (date->kind == 'J') {
+        return jan1 + date->day - 1 + (is_leap_year(year) && date->day >= 60);
+    }
+    if (date->kind == 'D') return jan1 + date->day;
+
+    // Weekday d of week w (5 = last) of month m
+    const int64_t first = days_from_civil(year, date->month, 1);
+    const int first_weekday = weekday_from_days(first);
+    int day = 1 + (date->weekday - first_weekday + 7) % 7 + (date->week - 1) * 7;
+    while (day > days_in_month(date->month, year)) day -= 7;
+    return first + day - 1;
+}
+
+/* 
+ * Stores the UTC instants at which daylight saving time starts and ends in year.
+ */
+static void tz_rule_transitions(const tz_rule_t *rule, int year, int64_t *start, int64_t *end) {
+    *start = tz_rule_day(&rule->start, year) * 86400 + rule->start.time - rule->std_offset;
+    *end = tz_rule_day(&rule->end, year) * 86400 + rule->end.time - rule->dst_offset;
+}
+
+/* 
+ * Offset in seconds east of UTC at the given instant, from the rule alone.
+ */
+static int32_t tz_rule_offset(const tz_rule_t *rule, int64_t epoch) {
+    if (!rule->has_dst) return rule->std_offset;
+
+    const int64_t days = epoch / 86400 - (epoch % 86400 < 0);
+    arcdate_t civil;
+    civil_from_days(days, &civil);
+    int64_t start, end;
+    tz_rule_transitions(rule, civil.year, &start, &end);
+    // Southern-hemisphere rules end daylight saving before they start it
+    const bool dst = start < end ? (epoch >= start && epoch < end) : (epoch < end || epoch >= start);
+    return dst ? rule->dst_offset : rule->std_offset;
+}
+
+/* 
+ * Offset in seconds east of UTC at the given instant.
+ */
+static int32_t zone_offset_seconds(const arcdate_zone_t *zone, int64_t epoch) {
+    if (zone->count == 0 || epoch < zone->at[0]) {
+        return zone->rule_before ? tz_rule_offset(&zone->rule, epoch) : zone->initial;
+    }
+    if (epoch >= zone->at[zone->count - 1] && zone->has_rule) return tz_rule_offset(&zone->rule, epoch);
+
+    // Last transition at or before epoch
+    size_t lo = 0, n = zone->count;
+    while (n > 1) {
+        const size_t half = n / 2;
+        if (zone->at[lo + half] <= epoch) lo += half;
+        n -= half;
+    }
+    return zone->offset[lo];
+}
+
+/* 
+ * Compiles a zone from a POSIX TZ rule: a 1970-2100 transition table, with the
+ * rule itself covering every other year from valid_from on. If the table cannot be allocated the
+ * zone answers every lookup from the rule, which gives the same offsets.
+ */
+static bool compile_rule_zone(const char *name, const char *posix, int64_t valid_from, arcdate_zone_t *zone) {
+    memset(zone, 0, sizeof(*zone));
+    zone->name = name;
+    zone->valid_from = valid_from;
+    if (!parse_tz_rule(posix, &zone->rule)) return false;
+    zone->initial = zone->rule.std_offset;
+    zone->rule_before = zone->rule.has_dst;
+    if (!zone->rule.has_dst) return true;
+
+    const size_t count = 2 * (TZ_TABLE_LAST_YEAR - TZ_TABLE_FIRST_YEAR + 1);
+    int64_t *at = (int64_t*)malloc(count * (sizeof(int64_t) + sizeof(int32_t)));
+    if (!at) return true;
+    int32_t *offset = (int32_t*)(at + count);
+
+    for (int year = TZ_TABLE_FIRST_YEAR, i = 0; year <= TZ_TABLE_LAST_YEAR; year++, i += 2) {
+        int64_t start, end;
+        tz_rule_transitions(&zone->rule, year, &start, &end);
+        const bool start_first = start < end;
+        at[i] = start_first ? start : end;
+        offset[i] = start_first ? zone->rule.dst_offset : zone->rule.std_offset;
+        at[i + 1] = start_first ? end : start;
+        offset[i + 1] = start_first ? zone->rule.std_offset : zone->rule.dst_offset;
+    }
+    zone->at = at;
+    zone->offset = offset;
+    zone->count = count;
+    zone->has_rule = true;
+    return true;
+}
+
+// An embedded zone: IANA name, POSIX rule from tzdata, the instant since which that rule
+// matches the zone's history, and the table compiled on first use
+typedef struct {
+    const char *name;
+    const char *posix;
+    int64_t valid_from;
+    arcdate_zone_t zone;
+    bool ready;
+    bool lock;
+} embedded_zone_t;
+
+// Sorted by name for binary search. valid_from is the UTC instant from which the rule
+// agrees with tzdata 2025b (the zone's most recent rule change)
+static embedded_zone_t embedded_zones[] = {
+    { "America/Chicago", "CST6CDT,M3.2.0,M11.1.0", 1162710000, { 0 }, false, false }, // 2006-11-05
+    { "America/Denver", "MST7MDT,M3.2.0,M11.1.0", 1162713600, { 0 }, false, false }, // 2006-11-05
+    { "America/Los_Angeles", "PST8PDT,M3.2.0,M11.1.0", 1162717200, { 0 }, false, false }, // 2006-11-05
+    { "America/New_York", "EST5EDT,M3.2.0,M11.1.0", 1162706400, { 0 }, false, false }, // 2006-11-05
+    { "America/Sao_Paulo", "<-03>3", 1550368800, { 0 }, false, false }, // 2019-02-17
+    { "America/St_Johns", "NST3:30NDT,M3.2.0,M11.1.0", 1299994200, { 0 }, false, false }, // 2011-03-13
+    { "Asia/Kathmandu", "<+0545>-5:45", 504901800, { 0 }, false, false }, // 1985-12-31
+    { "Asia/Kolkata", "IST-5:30", -764145000, { 0 }, false, false }, // 1945-10-14
+    { "Asia/Shanghai", "CST-8", 684867600, { 0 }, false, false }, // 1991-09-14
+    { "Asia/Tokyo", "JST-9", -577962000, { 0 }, false, false }, // 1951-09-08
+    { "Australia/Sydney", "AEST-10AEDT,M10.1.0,M4.1.0/3", 1193500800, { 0 }, false, false }, // 2007-10-27
+    { "Europe/Berlin", "CET-1CEST,M3.5.0,M10.5.0/3", 814928400, { 0 }, false, false }, // 1995-10-29
+    { "Europe/Istanbul", "<+03>-3", 1459040400, { 0 }, false, false }, // 2016-03-27
+    { "Europe/London", "GMT0BST,M3.5.0/1,M10.5.0", 814928400, { 0 }, false, false }, // 1995-10-29
+    { "Europe/Moscow", "MSK-3", 1414274400, { 0 }, false, false }, // 2014-10-25
+    { "Europe/Paris", "CET-1CEST,M3.5.0,M10.5.0/3", 814928400, { 0 }, false, false }, // 1995-10-29
+    { "Pacific/Auckland", "NZST-12NZDT,M9.5.0,M4.1.0/3", 1175349600, { 0 }, false, false }, // 2007-03-31
+    { "UTC", "UTC0", INT64_MIN, { 0 }, false, false },
+};
+
+/**
+ * @brief Looks up a time zone by IANA name (e.g., "Europe/Berlin").
+ *
+ * Embedded zones carry the current tzdata rules, compiled into a transition table
+ * on first use. Each rule only covers the instants since it last matched the zone's
+ * history (e.g. 1995-10-29 for Europe/Berlin, 2019-02-17 for America/Sao_Paulo);
+ * earlier instants are rejected by zone_offset() and convert_tz(). Use load_zone()
+ * for the full history. The returned zone lives for the rest of the program and
+ * may be shared between threads.
+ *
+ * @param name IANA zone name.
+ * @return Pointer to the zone, or NULL if name is NULL or unknown.
+ */
+HTTP_DATETIME_API const arcdate_zone_t* find_zone(const char *name) {
+    if (!name) return NULL;
+
+    size_t lo = 0, hi = sizeof(embedded_zones) / sizeof(embedded_zones[0]);
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        const int cmp = strcmp(name, embedded_zones[mid].name);
+        if (cmp == 0) {
+            embedded_zone_t *entry = &embedded_zones[mid];
+            if (!ATOMIC_LOAD_ACQUIRE(&entry->ready)) {
+                while (!ATOMIC_TRY_LOCK(&entry->lock)) { }
+                if (!entry->ready && compile_rule_zone(entry->name, entry->posix, entry->valid_from, &entry->zone)) {
+                    ATOMIC_STORE_RELEASE(&entry->ready, true);
+                }
+                ATOMIC_UNLOCK(&entry->lock);
+            }
+            return entry->ready ? &entry->zone : NULL;
+        }
+        if (cmp < 0) hi = mid;
+        else lo = mid + 1;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Returns a zone's GMT offset at the given instant.
+ *
+ * @param zone Zone from find_zone() or load_zone().
+ * @param epoch Seconds since 1970-01-01T00:00:00Z.
+ * @return Offset in minutes east of GMT (e.g., +60 or +120 for Europe/Berlin), or
+ *         ARCDATE_INVALID_OFFSET if epoch lies before the history the zone covers.
+ */
+HTTP_DATETIME_API int zone_offset(const arcdate_zone_t *zone, int64_t epoch) {
+    if (epoch < zone->valid_from) return ARCDATE_INVALID_OFFSET;
+    return (int)(zone_offset_seconds(zone, epoch) / 60);
+}
+
+/**
+ * @brief Converts an arcdate_t to local time in a zone, daylight saving included.
+ *
+ * The instant is kept; the fields and gmt_offset are replaced by the zone's local
+ * time and offset at that instant. The nanosecond field is preserved.
+ *
+ * @param date Pointer to the arcdate_t structure to convert.
+ * @param zone Zone from find_zone() or load_zone().
+ * @return ARCDATE_OK on success, ARCDATE_ERR_NULL if date or zone is NULL,
+ *         ARCDATE_ERR_RANGE if the instant lies before the history the zone covers
+ *         (date is left untouched).
+ */
+HTTP_DATETIME_API arcdate_status_t convert_tz(arcdate_t *date, const arcdate_zone_t *zone) {
+    if (!date || !zone) return ARCDATE_ERR_NULL;
+
+    const int64_t epoch = date_to_epoch(date);
+    const int offset = zone_offset(zone, epoch);
+    if (offset == ARCDATE_INVALID_OFFSET) return ARCDATE_ERR_RANGE;
+    const int nanosecond = date->nanosecond;
+    epoch_to_date(epoch, offset, date);
+    date->nanosecond = nanosecond;
+    return ARCDATE_OK;
+}
+
+/* 
+ * Reads big-endian integers from a TZif file.
+ */
+static int64_t read_be32(const unsigned char *p) {
+    return (int32_t)((uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3]);
+}
+
+static int64_t read_be64(const unsigned char *p) {
+    return (int64_t)((uint64_t)(uint32_t)read_be32(p) << 32 | (uint32_t)read_be32(p + 4));
+}
+
+// TZif header: magic, version, 15 reserved bytes, then six big-endian counts
+#define TZIF_HEADER_LEN 44
+
+// Counts from a TZif header
+typedef struct {
+    size_t isutcnt, isstdcnt, leapcnt, timecnt, typecnt, charcnt;
+} tzif_counts_t;
+
+/* 
+ * Reads a TZif header at p and returns the length of the data block that follows
+ * it for the given transition time size, or 0 if the header is invalid.
+ */
+static size_t read_tzif_header(const unsigned char *p, size_t time_size, tzif_counts_t *c) {
+    if (memcmp(p, "TZif", 4) != 0) return 0;
+    c->isutcnt = (size_t)(uint32_t)read_be32(p + 20);
+    c->isstdcnt = (size_t)(uint32_t)read_be32(p + 24);
+    c->leapcnt = (size_t)(uint32_t)read_be32(p + 28);
+    c->timecnt = (size_t)(uint32_t)read_be32(p + 32);
+    c->typecnt = (size_t)(uint32_t)read_be32(p + 36);
+    c->charcnt = (size_t)(uint32_t)read_be32(p + 40);
+    if (c->typecnt == 0 || c->typecnt > 256 || c->timecnt > 1 << 20 || c->leapcnt > 1 << 20 ||
+        c->charcnt > 1 << 20 || (c->isutcnt != 0 && c->isutcnt != c->typecnt) ||
+        (c->isstdcnt != 0 && c->isstdcnt != c->typecnt)) {
+        return 0;
+    }
+    return c->timecnt * time_size + c->timecnt + c->typecnt * 6 + c->charcnt +
+           c->leapcnt * (time_size + 4) + c->isstdcnt + c->isutcnt;
+}
+
+/* 
+ * Builds a zone from a TZif file (RFC 8536). Version 2+ files are read from their
+ * 64-bit section, with the footer TZ string covering instants after the last
+ * transition; version 1 files from their 32-bit section. The zone, its tables and
+ * its name share one allocation. Leap-second records are ignored.
+ */
+static arcdate_status_t parse_tzif(const unsigned char *data, size_t size, const char *name,
+                                   arcdate_zone_t **out) {
+    tzif_counts_t c;
+    if (size < TZIF_HEADER_LEN) return ARCDATE_ERR_FORMAT;
+    size_t block = read_tzif_header(data, 4, &c);
+    if (block == 0 || size - TZIF_HEADER_LEN < block) return ARCDATE_ERR_FORMAT;
+
+    const unsigned char *body = data + TZIF_HEADER_LEN;
+    size_t time_size = 4;
+    if (data[4] >= '2') {
+        const unsigned char *v2 = body + block;
+        if ((size_t)(data + size - v2) < TZIF_HEADER_LEN) return ARCDATE_ERR_FORMAT;
+        time_size = 8;
+        block = read_tzif_header(v2, 8, &c);
+        body = v2 + TZIF_HEADER_LEN;
+        if (block == 0 || (size_t)(data + size - body) < block) return ARCDATE_ERR_FORMAT;
+    }
+    const unsigned char *times = body;
+    const unsigned char *indices = times + c.timecnt * time_size;
+    const unsigned char *types = indices + c.timecnt;
+
+    // Footer: "\n<POSIX TZ string>\n", possibly empty
+    tz_rule_t rule;
+    bool has_rule = false;
+    if (time_size == 8) {
+        const char *footer = (const char *)(body + block);
+        const char *end = (const char *)data + size;
+        char posix[64];
+        if (footer < end && *footer == '\n') {
+            const char *close = (const char *)memchr(footer + 1, '\n', (size_t)(end - footer - 1));
+            const size_t len = close ? (size_t)(close - footer - 1) : 0;
+            if (!close || len >= sizeof(posix)) return ARCDATE_ERR_FORMAT;
+            memcpy(posix, footer + 1, len);
+            posix[len] = '\0';
+            if (len > 0) {
+                if (!parse_tz_rule(posix, &rule)) return ARCDATE_ERR_FORMAT;
+                has_rule = true;
+            }
+        }
+    }
+
+    const size_t name_len = strlen(name);
+    const size_t at_start = (sizeof(arcdate_zone_t) + 7) & ~(size_t)7;
+    char *block_mem = (char *)malloc(at_start + c.timecnt * (sizeof(int64_t) + sizeof(int32_t)) + name_len + 1);
+    if (!block_mem) return ARCDATE_ERR_NOMEM;
+    arcdate_zone_t *zone = (arcdate_zone_t *)block_mem;
+    int64_t *at = (int64_t *)(block_mem + at_start);
+    int32_t *offset = (int32_t *)(at + c.timecnt);
+    char *zone_name = (char *)(offset + c.timecnt);
+
+    for (size_t i = 0; i < c.timecnt; i++) {
+        at[i] = time_size == 8 ? read_be64(times + 8 * i) : read_be32(times + 4 * i);
+        if (indices[i] >= c.typecnt || (i > 0 && at[i] <= at[i - 1])) {
+            free(block_mem);
+            return ARCDATE_ERR_FORMAT;
+        }
+        offset[i] = (int32_t)read_be32(types + 6 * indices[i]);
+    }
+    memcpy(zone_name, name, name_len + 1);
+
+    memset(zone, 0, sizeof(*zone));
+    zone->name = zone_name;
+    zone->at = at;
+    zone->offset = offset;
+    zone->count = c.timecnt;
+    zone->initial = (int32_t)read_be32(types); // local time type 0 applies before the first transition
+    zone->has_rule = has_rule;
+    zone->rule_before = has_rule && c.timecnt == 0;
+    if (has_rule) zone->rule = rule;
+    zone->valid_from = INT64_MIN;
+    *out = zone;
+    return ARCDATE_OK;
+}
+
+// Open-addressed registry of loaded zones; a power of two well above the ~600 tzdata zones
+#define ZONE_REGISTRY_SLOTS 2048
+
+// Slots go from NULL to a zone exactly once and are never cleared
+static const arcdate_zone_t *zone_registry[ZONE_REGISTRY_SLOTS];
+
+/* 
+ * FNV-1a hash of a zone name.
+ */
+static uint32_t hash_zone_name(const char *name) {
+    uint32_t h = 2166136261u;
+    while (*name) h = (h ^ (unsigned char)*name++) * 16777619u;
+    return h;
+}
+
+/* 
+ * Returns the registered zone with this name, or NULL. Lock-free: probes until an
+ * empty slot, which no insertion can ever skip past.
+ */
+static const arcdate_zone_t *registry_find(const char *name, uint32_t hash) {
+    for (uint32_t i = 0; i < ZONE_REGISTRY_SLOTS; i++) {
+        const arcdate_zone_t *zone = ATOMIC_LOAD_ACQUIRE(&zone_registry[(hash + i) & (ZONE_REGISTRY_SLOTS - 1)]);
+        if (!zone) return NULL;
+        if (strcmp(zone->name, name) == 0) return zone;
+    }
+    return NULL;
+}
+
+/* 
+ * Publishes zone with a compare-and-swap into the first empty slot of its probe
+ * sequence. If another thread registered the same name first, that zone wins and
+ * is returned; the caller then owns (and frees) its own copy. Returns NULL when
+ * the registry is full.
+ */
+static const arcdate_zone_t *registry_insert(const arcdate_zone_t *zone, uint32_t hash) {
+    for (uint32_t i = 0; i < ZONE_REGISTRY_SLOTS; i++) {
+        const arcdate_zone_t **slot = &zone_registry[(hash + i) & (ZONE_REGISTRY_SLOTS - 1)];
+        const arcdate_zone_t *expected = NULL;
+        if (ATOMIC_CAS(slot, &expected, zone)) return zone;
+        if (strcmp(expected->name, zone->name) == 0) return expected;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Loads a time zone from the system tz database (e.g., "Europe/Berlin").
+ *
+ * The TZif file under $TZDIR (default /usr/share/zoneinfo) is memory-mapped and
+ * parsed once into an immutable transition table, including the full history of
+ * the zone; later calls for the same name are a lock-free hash lookup. Zones are
+ * shared by all threads and live for the rest of the program. There is no silent
+ * fallback: when the file does not exist the call fails with ARCDATE_ERR_IO, and
+ * the caller may choose find_zone() and its shorter history instead. Offsets are reported in whole minutes (pre-1900 local mean time is truncated).
+ *
+ * @param name IANA zone name; must not be absolute or contain "..".
+ * @param zone Receives the zone on success.
+ * @return ARCDATE_OK on success, ARCDATE_ERR_NULL if an argument is NULL,
+ *         ARCDATE_ERR_IO if the zone does not exist, ARCDATE_ERR_FORMAT for an invalid
+ *         name or file, ARCDATE_ERR_NOMEM if allocation fails.
+ */
+HTTP_DATETIME_API arcdate_status_t load_zone(const char *name, const arcdate_zone_t **zone) {
+    if (!name || !zone) return ARCDATE_ERR_NULL;
+
+    const uint32_t hash = hash_zone_name(name);
+    const arcdate_zone_t *found = registry_find(name, hash);
+    if (found) {
+        *zone = found;
+        return ARCDATE_OK;
+    }
+
+    const size_t name_len = strlen(name);
+    if (name_len == 0 || name_len > 255 || name[0] == '/' || strstr(name, "..")) return ARCDATE_ERR_FORMAT;
+    const char *dir = getenv("TZDIR");
+    if (!dir || !*dir) dir = "/usr/share/zoneinfo";
+    char path[4096];
+    const size_t dir_len = strlen(dir);
+    if (dir_len + 1 + name_len >= sizeof(path)) return ARCDATE_ERR_FORMAT;
+    memcpy(path, dir, dir_len);
+    path[dir_len] = '/';
+    memcpy(path + dir_len + 1, name, name_len + 1);
+
+    file_view_t view;
+    arcdate_status_t status = open_file_view(path, &view);
+    arcdate_zone_t *loaded = NULL;
+    if (status == ARCDATE_OK) {
+        status = parse_tzif((const unsigned char *)view.data, view.size, name, &loaded);
+        close_file_view(&view);
+    }
+
+    if (status != ARCDATE_OK) return status;
+
+    const arcdate_zone_t *winner = registry_insert(loaded, hash);
+    if (winner != loaded) free(loaded);
+    if (!winner) return ARCDATE_ERR_NOMEM;
+    *zone = winner;
+    return ARCDATE_OK;
 }
@@ -43,13 +43,16 @@
  *
  * License: MIT License
  * Author: Arda 'Arc' Akgür (Original Concept and Core Logic)
- * Version: 1.0 (2025 Edition)
+ * Version: 2.0 (2025 Edition)
  */
 
 #ifndef HTTP_DATETIME_PARSER_H
 #define HTTP_DATETIME_PARSER_H
 
 #include <stdbool.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
 
 typedef struct {
     int year;       // Year, e.g., 2025
@@ -59,20 +62,149 @@ typedef struct {
     int minute;     // Minute (0-59)
     int second;     // Second (0-59)
     int weekday;    // 0=Sun, 1=Mon, ..., 6=Sat
-    int gmt_offset; // GMT offset, e.g., 0, +3, -5
+    int gmt_offset; // GMT offset in minutes, e.g., 0, +180, -300, +330
+    int nanosecond; // Fraction of the second (0-999999999); 0 when the source has none
 } arcdate_t;
 
+// Status codes returned by the non-allocating entry points
+typedef enum {
+    ARCDATE_OK = 0,          // Success
+    ARCDATE_ERR_NULL = -1,   // Required pointer argument was NULL
+    ARCDATE_ERR_FORMAT = -2, // Input is not a recognised HTTP Date
+    ARCDATE_ERR_IO = -3,     // File could not be opened, mapped or read
+    ARCDATE_ERR_NOMEM = -4,  // Memory allocation failed
+    ARCDATE_ERR_RANGE = -5   // Instant lies before the history a time zone covers
+} arcdate_status_t;
+
+// Outcome of if_modified_since() / if_unmodified_since()
+typedef enum {
+    ARCDATE_PROCEED = 0,              // Condition passed or was ignored: serve normally (200)
+    ARCDATE_NOT_MODIFIED = 304,       // If-Modified-Since: not modified, answer 304
+    ARCDATE_PRECONDITION_FAILED = 412 // If-Unmodified-Since: modified, answer 412
+} arcdate_condition_t;
+
+// One input string for parse_dates_batch(); need not be NUL-terminated
+typedef struct {
+    const char *ptr;
+    size_t len;
+} arcdate_span_t;
+
+// Struct-of-arrays output for parse_dates_batch(); any column may be NULL to skip it
+typedef struct {
+    int *years;
+    int *months;
+    int *days;
+    int *hours;
+    int *minutes;
+    int *seconds;
+    int64_t *epochs;
+    arcdate_status_t *status;
+} arcdate_batch_t;
+
+// Where extract_log_dates() finds the HTTP Date on each log line
+typedef struct {
+    char open;      // Date is between the first 'open' and the next 'close' (e.g. '[' ']'), or '\0'
+    char close;
+    char delimiter; // Otherwise: field separator, e.g. '\t' or '|'
+    int column;     //            and the zero-based column holding the date
+} arcdate_log_format_t;
+
+// Length of an RFC 7231 IMF-fixdate, e.g. "Sun, 06 Nov 1994 08:49:37 GMT"
+#define ARCDATE_IMF_FIXDATE_LEN 29
+
+// Buffer size that fits any to_rfc3339_buf() output, e.g. "2015-10-21T10:28:00.123456789+03:00", with the NUL
+#define ARCDATE_RFC3339_MAX 36
+
+// Buffer size that fits any to_date_string() / to_date_string_buf() output, including the NUL
+#define ARCDATE_STRING_MAX 100
+
+// Returned by http_date_to_epoch() when the input is not a valid HTTP Date
+#define ARCDATE_INVALID_EPOCH INT64_MIN
+
+// 64-bit packed date from pack_date(): UTC fields then offset, so packed values order by instant
+typedef uint64_t arcdate_packed_t;
+
+// Returned by pack_date() when the date does not fit the packed layout
+#define ARCDATE_PACKED_INVALID ((arcdate_packed_t)0)
+
+// IMF-fixdate kernel for set_imf_kernel(); AUTO picks the fastest one the CPU supports
+typedef enum {
+    ARCDATE_KERNEL_AUTO = 0,
+    ARCDATE_KERNEL_SCALAR,
+    ARCDATE_KERNEL_SSE42,
+    ARCDATE_KERNEL_AVX2
+} arcdate_kernel_t;
+
+// Time zone returned by find_zone() / load_zone(); opaque, lives for the rest of the program
+typedef struct arcdate_zone arcdate_zone_t;
+
+// Returned by zone_offset() for an instant before the history the zone covers
+#define ARCDATE_INVALID_OFFSET INT_MIN
+
+// Define HTTP_DATETIME_HEADER_ONLY before including this header to compile the whole library into
+// the including translation unit, with every function static inline; do not link the .c file then
+#ifdef HTTP_DATETIME_HEADER_ONLY
+#define HTTP_DATETIME_API static inline
+#else
+#define HTTP_DATETIME_API
+#endif
+
 // Main functions
-arcdate_t* generate_date(const char *httpDate, int gmt_offset);
-char* to_date_string(const arcdate_t *date);
-void convert(arcdate_t *date, int new_gmt_offset);
-void free_date(arcdate_t *date);
+HTTP_DATETIME_API arcdate_t* generate_date(const char *httpDate, int gmt_offset);
+HTTP_DATETIME_API arcdate_status_t parse_date(const char *httpDate, int gmt_offset, arcdate_t *date);
+HTTP_DATETIME_API char* to_date_string(const arcdate_t *date);
+HTTP_DATETIME_API size_t to_date_string_buf(const arcdate_t *date, char *buf, size_t size);
+HTTP_DATETIME_API size_t to_imf_fixdate(const arcdate_t *date, char *buf);
+HTTP_DATETIME_API const char* http_date_now(void);
+HTTP_DATETIME_API arcdate_status_t parse_rfc3339(const char *str, size_t len, arcdate_t *date);
+HTTP_DATETIME_API size_t to_rfc3339_buf(const arcdate_t *date, char *buf, size_t size);
+HTTP_DATETIME_API void set_coarse_clock(bool enabled);
+HTTP_DATETIME_API bool set_imf_kernel(arcdate_kernel_t kernel);
+HTTP_DATETIME_API void convert(arcdate_t *date, int new_gmt_offset);
+HTTP_DATETIME_API void free_date(arcdate_t *date);
 
 // Date manipulation functions
-void add_hours(arcdate_t *date, int hours);
-void add_minutes(arcdate_t *date, int minutes);
-void add_days(arcdate_t *date, int days);
-void add_months(arcdate_t *date, int months);
-void add_years(arcdate_t *date, int years);
+HTTP_DATETIME_API void add_hours(arcdate_t *date, int hours);
+HTTP_DATETIME_API void add_minutes(arcdate_t *date, int minutes);
+HTTP_DATETIME_API void add_days(arcdate_t *date, int days);
+HTTP_DATETIME_API void add_months(arcdate_t *date, int months);
+HTTP_DATETIME_API void add_years(arcdate_t *date, int years);
+HTTP_DATETIME_API void add_seconds(arcdate_t *date, int64_t seconds);
+HTTP_DATETIME_API void add_nanoseconds(arcdate_t *date, int64_t nanoseconds);
+
+// Unix time conversion
+HTTP_DATETIME_API int64_t date_to_epoch(const arcdate_t *date);
+HTTP_DATETIME_API void epoch_to_date(int64_t epoch, int gmt_offset, arcdate_t *date);
+HTTP_DATETIME_API int64_t http_date_to_epoch(const char *httpDate, size_t len);
+
+// Comparison
+HTTP_DATETIME_API int compare_dates(const arcdate_t *a, const arcdate_t *b);
+HTTP_DATETIME_API int64_t diff_seconds(const arcdate_t *a, const arcdate_t *b);
+
+// Time zones
+HTTP_DATETIME_API const arcdate_zone_t* find_zone(const char *name);
+HTTP_DATETIME_API arcdate_status_t load_zone(const char *name, const arcdate_zone_t **zone);
+HTTP_DATETIME_API int zone_offset(const arcdate_zone_t *zone, int64_t epoch);
+HTTP_DATETIME_API arcdate_status_t convert_tz(arcdate_t *date, const arcdate_zone_t *zone);
+
+// Conditional requests
+HTTP_DATETIME_API arcdate_condition_t if_modified_since(const char *header, size_t len, int64_t mtime);
+HTTP_DATETIME_API arcdate_condition_t if_unmodified_since(const char *header, size_t len, int64_t mtime);
+
+// Packed representation
+HTTP_DATETIME_API arcdate_packed_t pack_date(const arcdate_t *date);
+HTTP_DATETIME_API arcdate_status_t unpack_date(arcdate_packed_t packed, arcdate_t *date);
+
+// Batch parsing
+HTTP_DATETIME_API size_t parse_dates_batch(const arcdate_span_t *inputs, size_t count,
+                                           const arcdate_batch_t *out);
+HTTP_DATETIME_API size_t parse_dates_batch_parallel(const arcdate_span_t *inputs, size_t count,
+                                                    const arcdate_batch_t *out, unsigned int threads);
+HTTP_DATETIME_API arcdate_status_t extract_log_dates(const char *path, const arcdate_log_format_t *format,
+                                                     int64_t **epochs, size_t *count);
+
+#ifdef HTTP_DATETIME_HEADER_ONLY
+#include "http_datetime_parser.c"
+#endif
 
 #endif // HTTP_DATETIME_PARSER_H
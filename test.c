@@ -1,28 +1,153 @@
-include <stdio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include "http_datetime_parser.h"
 /*
 aakgur@instance-20250423-141426:~/datetime$ ./test_datetime 
 Testing HTTP Datetime Parser Library...
 Parsed and shifted date: Wed, 21 Oct 2015 10:28:00 GMT+3
 Converted to GMT+5: Wed, 21 Oct 2015 12:28:00 GMT+5
-After adding 2 days: Wed, 23 Oct 2015 12:28:00 GMT+5
-After subtracting 90 minutes: Wed, 23 Oct 2015 10:58:00 GMT+5
+After adding 2 days: Fri, 23 Oct 2015 12:28:00 GMT+5
+After subtracting 90 minutes: Fri, 23 Oct 2015 10:58:00 GMT+5
 Current UTC time: Sun, 27 Apr 2025 18:16:11 GMT+0
+Stack parsed date: Wed, 21 Oct 2015 07:28:00 GMT+0
+Date header: Sun, 27 Apr 2025 18:16:11 GMT
 All tests completed.
 */
+static int failures = 0;
+
+// Compares a formatted date against the expected text and reports mismatches
+static void expect_str(const char *what, const char *got, const char *want) {
+    if (!got || strcmp(got, want) != 0) {
+        printf("FAIL %s: got \"%s\", want \"%s\"\n", what, got ? got : "(null)", want);
+        failures++;
+    }
+}
+
+static const char *const month_abbr[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+
+// Test 7 tables: fixed-width IMF-fixdate validation, run once per IMF-fixdate kernel
+static void check_imf_dates(const char *kernel) {
+    arcdate_t date;
+    char *str;
+    const char *valid_dates[] = {
+        "Sun, 06 Nov 1994 08:49:37 GMT",
+        "Thu, 29 Feb 2024 23:59:59 GMT",
+        "Sat, 01 Jan 2000 00:00:00 GMT",
+    };
+    const char *invalid_dates[] = {
+        "Sun, 6 Nov 1994 08:49:37 GMT",   // day not zero-padded
+        "Sun, 06 Nov 1994 08:49:37 UTC",  // wrong zone
+        "Sun, 06 Nov 1994 08:49:37 GMT ", // trailing byte
+        "Sun, 06 Nov 1994 08:49:37",      // truncated
+        "Sun, 06 Foo 1994 08:49:37 GMT",  // unknown month
+        "Xyz, 06 Nov 1994 08:49:37 GMT",  // unknown weekday
+        "Thu, 29 Feb 2023 12:00:00 GMT",  // not a leap year
+        "Sun, 06 Nov 1994 24:00:00 GMT",  // hour out of range
+        "Sun, 06 Nov 19x4 08:49:37 GMT",  // non-digit year
+        "Sun, 06 Nov 1994 08-49:37 GMT",  // wrong time separator
+        "Sun, 06 Nov 1994 08:49:3/ GMT",  // non-digit second
+        "Sun, 06 Nov 1994 08:49:37 GMt",  // lowercase zone
+        "Sun; 06 Nov 1994 08:49:37 GMT",  // wrong weekday separator
+    };
+    for (size_t i = 0; i < sizeof(valid_dates) / sizeof(valid_dates[0]); i++) {
+        if (parse_date(valid_dates[i], 0, &date) != ARCDATE_OK) {
+            printf("FAIL %s kernel: rejected valid date \"%s\"\n", kernel, valid_dates[i]);
+            failures++;
+            continue;
+        }
+        str = to_date_string(&date);
+        char want[40];
+        snprintf(want, sizeof(want), "%s+0", valid_dates[i]);
+        char what[40];
+        snprintf(what, sizeof(what), "%s kernel round trip", kernel);
+        expect_str(what, str, want);
+        free(str);
+    }
+    for (size_t i = 0; i < sizeof(invalid_dates) / sizeof(invalid_dates[0]); i++) {
+        if (parse_date(invalid_dates[i], 0, &date) != ARCDATE_ERR_FORMAT) {
+            printf("FAIL %s kernel: accepted invalid date \"%s\"\n", kernel, invalid_dates[i]);
+            failures++;
+        }
+    }
+}
+
+// Test 8 tables: every month and weekday name decodes through the name hash
+static void check_name_lookup(const char *kernel) {
+    arcdate_t date;
+    const char *first_of_month_2020[] = { "Wed", "Sat", "Sun", "Wed", "Fri", "Mon", "Wed", "Sat", "Tue", "Thu", "Sun", "Tue" };
+    const char *weekday_abbr[] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+    for (int m = 0; m < 12; m++) {
+        char input[40];
+        snprintf(input, sizeof(input), "%s, 01 %s 2020 12:00:00 GMT", first_of_month_2020[m], month_abbr[m]);
+        if (parse_date(input, 0, &date) != ARCDATE_OK || date.month != m + 1) {
+            printf("FAIL %s kernel: month lookup for \"%s\"\n", kernel, input);
+            failures++;
+        }
+    }
+    for (int w = 0; w < 7; w++) {
+        char input[40];
+        snprintf(input, sizeof(input), "%s, %02d Jan 2020 12:00:00 GMT", weekday_abbr[w], 5 + w);
+        if (parse_date(input, 0, &date) != ARCDATE_OK || date.weekday != w) {
+            printf("FAIL %s kernel: weekday lookup for \"%s\"\n", kernel, input);
+            failures++;
+        }
+    }
+#ifndef HTTP_DATETIME_CASE_INSENSITIVE
+    if (parse_date("WED, 21 OCT 2015 07:28:00 GMT", 0, &date) != ARCDATE_ERR_FORMAT) {
+        printf("FAIL %s kernel: accepted upper-case names\n", kernel);
+        failures++;
+    }
+#else
+    if (parse_date("WED, 21 oCT 2015 07:28:00 GMT", 0, &date) != ARCDATE_OK) {
+        printf("FAIL %s kernel: rejected mixed-case names\n", kernel);
+        failures++;
+    }
+#endif
+}
+
+// Test 15 tables: obsolete RFC 850 and asctime() formats, accepted and rejected
+static void check_legacy_dates(const char *kernel) {
+    arcdate_t date;
+    const char *legacy_dates[] = {
+        "Wednesday, 21-Oct-15 07:28:00 GMT",
+        "Wed Oct 21 07:28:00 2015",
+    };
+    for (size_t i = 0; i < sizeof(legacy_dates) / sizeof(legacy_dates[0]); i++) {
+        if (http_date_to_epoch(legacy_dates[i], strlen(legacy_dates[i])) != 1445412480) {
+            printf("FAIL %s kernel: legacy date \"%s\"\n", kernel, legacy_dates[i]);
+            failures++;
+        }
+    }
+    const char *invalid_legacy[] = {
+        "Sunda, 06-Nov-94 08:49:37 GMT",    // truncated weekday
+        "Sunday, 06 Nov 94 08:49:37 GMT",   // wrong separators
+        "Sunday, 06-Nov-94 08:49:37 UTC",   // wrong zone
+        "Sun Nov 6 08:49:37 1994",          // day not padded
+        "Sun Nov  6 08:49:37 1994 ",        // trailing byte
+    };
+    for (size_t i = 0; i < sizeof(invalid_legacy) / sizeof(invalid_legacy[0]); i++) {
+        if (parse_date(invalid_legacy[i], 0, &date) != ARCDATE_ERR_FORMAT) {
+            printf("FAIL %s kernel: accepted invalid date \"%s\"\n", kernel, invalid_legacy[i]);
+            failures++;
+        }
+    }
+}
+
 int main() {
     printf("Testing HTTP Datetime Parser Library...\n");
 
     // Test 1: Parse a given HTTP Date string
     const char *http_date = "Wed, 21 Oct 2015 07:28:00 GMT";
-    arcdate_t *date = generate_date(http_date, 3); // parse and shift to GMT+3
+    arcdate_t *date = generate_date(http_date, 180); // parse and shift to GMT+3
 
     char *str = to_date_string(date);
     printf("Parsed and shifted date: %s\n", str);
     free(str);
 
     // Test 2: Convert to GMT+5
-    convert(date, 5);
+    convert(date, 300);
     str = to_date_string(date);
     printf("Converted to GMT+5: %s\n", str);
     free(str);
@@ -49,6 +174,573 @@ int main() {
 
     free_date(now);
 
+    // Test 6: Parse into a caller-provided (stack) arcdate_t
+    arcdate_t stack_date;
+    if (parse_date(http_date, 0, &stack_date) != ARCDATE_OK) {
+        printf("FAIL parse_date returned an error\n");
+        failures++;
+    }
+    str = to_date_string(&stack_date);
+    printf("Stack parsed date: %s\n", str);
+    expect_str("parse_date", str, "Wed, 21 Oct 2015 07:28:00 GMT+0");
+    free(str);
+
+    if (parse_date("not a date", 0, &stack_date) != ARCDATE_ERR_FORMAT) {
+        printf("FAIL parse_date accepted garbage\n");
+        failures++;
+    }
+    if (generate_date("not a date", 0) != NULL) {
+        printf("FAIL generate_date accepted garbage\n");
+        failures++;
+    }
+
+    // Test 7: Fixed-width IMF-fixdate validation
+    check_imf_dates("default");
+
+    // Test 8: Every month and weekday name decodes through the name hash
+    check_name_lookup("default");
+
+    // Test 9: Constant-time day arithmetic across months, leap days and centuries
+    parse_date("Wed, 21 Oct 2015 07:28:00 GMT", 0, &stack_date);
+    add_days(&stack_date, 36500);
+    str = to_date_string(&stack_date);
+    expect_str("add 36500 days", str, "Fri, 27 Sep 2115 07:28:00 GMT+0");
+    free(str);
+    add_days(&stack_date, -36500);
+    str = to_date_string(&stack_date);
+    expect_str("subtract 36500 days", str, "Wed, 21 Oct 2015 07:28:00 GMT+0");
+    free(str);
+    parse_date("Tue, 01 Mar 2000 00:30:00 GMT", 0, &stack_date);
+    add_minutes(&stack_date, -60);
+    str = to_date_string(&stack_date);
+    expect_str("back into leap day", str, "Tue, 29 Feb 2000 23:30:00 GMT+0");
+    free(str);
+    parse_date("Thu, 01 Jan 1970 00:00:00 GMT", 0, &stack_date);
+    add_days(&stack_date, -1);
+    str = to_date_string(&stack_date);
+    expect_str("before the epoch", str, "Wed, 31 Dec 1969 00:00:00 GMT+0");
+    free(str);
+    // Month and year steps derive the weekday too
+    parse_date("Wed, 21 Oct 2015 07:28:00 GMT", 0, &stack_date);
+    add_months(&stack_date, 1);
+    str = to_date_string(&stack_date);
+    expect_str("add 1 month", str, "Sat, 21 Nov 2015 07:28:00 GMT+0");
+    free(str);
+    add_years(&stack_date, 1);
+    str = to_date_string(&stack_date);
+    expect_str("add 1 year", str, "Mon, 21 Nov 2016 07:28:00 GMT+0");
+    free(str);
+
+    // Test 10: Unix time conversion honours the GMT offset
+    parse_date("Wed, 21 Oct 2015 07:28:00 GMT", 180, &stack_date);
+    if (date_to_epoch(&stack_date) != 1445412480) {
+        printf("FAIL date_to_epoch: got %lld\n", (long long)date_to_epoch(&stack_date));
+        failures++;
+    }
+    epoch_to_date(1445412480, -300, &stack_date);
+    str = to_date_string(&stack_date);
+    expect_str("epoch_to_date", str, "Wed, 21 Oct 2015 02:28:00 GMT-5");
+    free(str);
+    epoch_to_date(-1, 0, &stack_date);
+    str = to_date_string(&stack_date);
+    expect_str("epoch_to_date before epoch", str, "Wed, 31 Dec 1969 23:59:59 GMT+0");
+    free(str);
+    if (date_to_epoch(&stack_date) != -1) {
+        printf("FAIL date_to_epoch before epoch\n");
+        failures++;
+    }
+
+    // Test 11: HTTP Date straight to Unix time, without NUL termination
+    const char header_line[] = "Last-Modified: Wed, 21 Oct 2015 07:28:00 GMT\r\n";
+    if (http_date_to_epoch(header_line + 15, 29) != 1445412480) {
+        printf("FAIL http_date_to_epoch on a header slice\n");
+        failures++;
+    }
+    if (http_date_to_epoch(header_line + 15, 30) != ARCDATE_INVALID_EPOCH ||
+        http_date_to_epoch("Wed, 21 Oct 2015 07:28:00 GMX", 29) != ARCDATE_INVALID_EPOCH ||
+        http_date_to_epoch(NULL, 0) != ARCDATE_INVALID_EPOCH) {
+        printf("FAIL http_date_to_epoch accepted invalid input\n");
+        failures++;
+    }
+
+    // Test 12: Cached Date header value for the current second
+    const char *header = http_date_now();
+    int64_t header_epoch = http_date_to_epoch(header, strlen(header));
+    int64_t wall = (int64_t)time(NULL);
+    printf("Date header: %s\n", header);
+    // time() may trail clock_gettime(CLOCK_REALTIME) by a kernel tick
+    if (header_epoch == ARCDATE_INVALID_EPOCH || header_epoch > wall + 1 || wall - header_epoch > 1) {
+        printf("FAIL http_date_now returned \"%s\"\n", header);
+        failures++;
+    }
+
+    // Test 13: Formatting into a caller buffer matches the snprintf layout byte for byte
+    const arcdate_t format_cases[] = {
+        { 2015, 10, 21, 7, 28, 0, 3, 0, 0 },
+        { 1994, 11, 6, 8, 49, 37, 0, 720, 0 },
+        { 7, 1, 1, 0, 0, 0, 1, -660, 0 },
+        { 12345, 12, 31, 23, 59, 59, 6, -300, 0 },
+        { -44, 3, 15, 12, 0, 0, 5, 60, 0 },
+    };
+    for (size_t i = 0; i < sizeof(format_cases) / sizeof(format_cases[0]); i++) {
+        const arcdate_t *d = &format_cases[i];
+        const char *wd[] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+        char want[ARCDATE_STRING_MAX], got[ARCDATE_STRING_MAX];
+        int want_len = snprintf(want, sizeof(want), "%s, %02d %s %04d %02d:%02d:%02d GMT%+d",
+                                wd[d->weekday], d->day, month_abbr[d->month - 1], d->year,
+                                d->hour, d->minute, d->second, d->gmt_offset / 60);
+        size_t got_len = to_date_string_buf(d, got, sizeof(got));
+        expect_str("to_date_string_buf", got, want);
+        if (got_len != (size_t)want_len) {
+            printf("FAIL to_date_string_buf length %zu, want %d\n", got_len, want_len);
+            failures++;
+        }
+    }
+    char small[10] = "xxxxxxxxx";
+    if (to_date_string_buf(&format_cases[0], small, sizeof(small)) != 0 || small[0] != '\0') {
+        printf("FAIL to_date_string_buf overflowed a short buffer\n");
+        failures++;
+    }
+
+    // Test 14: RFC 7231 output is always the 29-byte UTC IMF-fixdate
+    char imf[ARCDATE_IMF_FIXDATE_LEN + 1] = { 0 };
+    parse_date("Wed, 21 Oct 2015 23:28:00 GMT", 180, &stack_date); // 02:28 on the 22nd at GMT+3
+    if (to_imf_fixdate(&stack_date, imf) != ARCDATE_IMF_FIXDATE_LEN) {
+        printf("FAIL to_imf_fixdate length\n");
+        failures++;
+    }
+    expect_str("to_imf_fixdate", imf, "Wed, 21 Oct 2015 23:28:00 GMT");
+    stack_date = format_cases[3]; // year 12345
+    if (to_imf_fixdate(&stack_date, imf) != 0) {
+        printf("FAIL to_imf_fixdate accepted a five-digit year\n");
+        failures++;
+    }
+
+    // Test 15: Obsolete RFC 850 and asctime() formats decode to the same instant
+    check_legacy_dates("default");
+    parse_date("Sun Nov  6 08:49:37 1994", 0, &stack_date);
+    str = to_date_string(&stack_date);
+    expect_str("asctime single-digit day", str, "Sun, 06 Nov 1994 08:49:37 GMT+0");
+    free(str);
+    parse_date("Sunday, 06-Nov-94 08:49:37 GMT", 0, &stack_date);
+    str = to_date_string(&stack_date);
+    expect_str("RFC 850 two-digit year", str, "Sun, 06 Nov 1994 08:49:37 GMT+0");
+    free(str);
+    // Exactly 50 years ahead stays in this century; 51 years ahead goes back one
+    parse_date(NULL, 0, &stack_date);
+    const int this_year = stack_date.year;
+    char rfc850_buf[40];
+    for (int ahead = 50; ahead <= 51; ahead++) {
+        snprintf(rfc850_buf, sizeof(rfc850_buf), "Monday, 01-Jul-%02d 12:00:00 GMT", (this_year + ahead) % 100);
+        const int want = ahead == 50 ? this_year + 50 : this_year - 49;
+        if (parse_date(rfc850_buf, 0, &stack_date) != ARCDATE_OK || stack_date.year != want) {
+            printf("FAIL RFC 850 \"%s\" gave %d, want %d\n", rfc850_buf, stack_date.year, want);
+            failures++;
+        }
+    }
+
+    // Test 16: Batch parsing into struct-of-arrays output
+    const char *batch_text[] = {
+        "Wed, 21 Oct 2015 07:28:00 GMT",
+        "garbage",
+        "Sunday, 06-Nov-94 08:49:37 GMT",
+        "Sat Jan  1 00:00:00 2000",
+        "Thu, 01 Jan 1970 00:00:00 GMT",
+    };
+    enum { BATCH_N = 70 }; // spans more than one internal chunk
+    arcdate_span_t spans[BATCH_N];
+    int64_t epochs[BATCH_N];
+    int years[BATCH_N];
+    arcdate_status_t statuses[BATCH_N];
+    for (int i = 0; i < BATCH_N; i++) {
+        spans[i].ptr = batch_text[i % 5];
+        spans[i].len = strlen(batch_text[i % 5]);
+    }
+    arcdate_batch_t batch = { years, NULL, NULL, NULL, NULL, NULL, epochs, statuses };
+    size_t parsed = parse_dates_batch(spans, BATCH_N, &batch);
+    if (parsed != BATCH_N - BATCH_N / 5) {
+        printf("FAIL parse_dates_batch parsed %zu\n", parsed);
+        failures++;
+    }
+    for (int i = 0; i < BATCH_N; i++) {
+        if (epochs[i] != http_date_to_epoch(spans[i].ptr, spans[i].len) ||
+            statuses[i] != (i % 5 == 1 ? ARCDATE_ERR_FORMAT : ARCDATE_OK) ||
+            (i % 5 == 3 && years[i] != 2000)) {
+            printf("FAIL parse_dates_batch entry %d\n", i);
+            failures++;
+        }
+    }
+
+    // Test 17: Parallel batch parsing matches the serial result
+    const size_t big_n = 3 * 4096 + 17;
+    arcdate_span_t *big_spans = malloc(big_n * sizeof(*big_spans));
+    int64_t *serial_epochs = malloc(big_n * sizeof(*serial_epochs));
+    int64_t *parallel_epochs = malloc(big_n * sizeof(*parallel_epochs));
+    for (size_t i = 0; i < big_n; i++) {
+        big_spans[i].ptr = batch_text[i % 5];
+        big_spans[i].len = strlen(batch_text[i % 5]);
+    }
+    arcdate_batch_t serial_out = { NULL, NULL, NULL, NULL, NULL, NULL, serial_epochs, NULL };
+    arcdate_batch_t parallel_out = { NULL, NULL, NULL, NULL, NULL, NULL, parallel_epochs, NULL };
+    size_t serial_parsed = parse_dates_batch(big_spans, big_n, &serial_out);
+    size_t parallel_parsed = parse_dates_batch_parallel(big_spans, big_n, &parallel_out, 4);
+    if (serial_parsed != parallel_parsed ||
+        memcmp(serial_epochs, parallel_epochs, big_n * sizeof(*serial_epochs)) != 0) {
+        printf("FAIL parse_dates_batch_parallel differs from parse_dates_batch\n");
+        failures++;
+    }
+    free(big_spans);
+    free(serial_epochs);
+    free(parallel_epochs);
+
+    // Test 18: Extracting dates from a log file by delimiters and by column
+    const char *log_path = "test_access.log";
+    const arcdate_log_format_t bracketed = { '[', ']', '\0', 0 };
+    int64_t *log_epochs = NULL;
+    size_t log_count = 0;
+    FILE *log = fopen(log_path, "wb");
+    if (log) {
+        fputs("10.0.0.1\tGET /\tWed, 21 Oct 2015 07:28:00 GMT\t200\n", log);
+        fputs("10.0.0.2\tGET /a\tnot a date\t404\r\n", log);
+        fputs("10.0.0.3\tGET /b\tThu, 01 Jan 1970 00:00:00 GMT", log);
+        fclose(log);
+
+        const arcdate_log_format_t by_column = { '\0', '\0', '\t', 2 };
+        if (extract_log_dates(log_path, &by_column, &log_epochs, &log_count) != ARCDATE_OK || log_count != 3 ||
+            log_epochs[0] != 1445412480 || log_epochs[1] != ARCDATE_INVALID_EPOCH || log_epochs[2] != 0) {
+            printf("FAIL extract_log_dates by column\n");
+            failures++;
+        }
+        free(log_epochs);
+
+        log = fopen(log_path, "wb");
+        fputs("GET / [Sun, 06 Nov 1994 08:49:37 GMT] 200\n", log);
+        fputs("GET / 200\n", log);
+        fclose(log);
+        if (extract_log_dates(log_path, &bracketed, &log_epochs, &log_count) != ARCDATE_OK || log_count != 2 ||
+            log_epochs[0] != 784111777 || log_epochs[1] != ARCDATE_INVALID_EPOCH) {
+            printf("FAIL extract_log_dates by delimiters\n");
+            failures++;
+        }
+        free(log_epochs);
+        remove(log_path);
+    }
+    if (extract_log_dates("/nonexistent/access.log", &bracketed, &log_epochs, &log_count) != ARCDATE_ERR_IO) {
+        printf("FAIL extract_log_dates on a missing file\n");
+        failures++;
+    }
+
+    // Test 19: The current-time path agrees with the system clock and libc
+    time_t before = time(NULL);
+    parse_date(NULL, 0, &stack_date);
+    time_t after = time(NULL);
+    // time() may itself trail clock_gettime(CLOCK_REALTIME) by a kernel tick
+    if (date_to_epoch(&stack_date) < (int64_t)before || date_to_epoch(&stack_date) > (int64_t)after + 1) {
+        printf("FAIL parse_date(NULL) is not the current time\n");
+        failures++;
+    }
+    time_t current = (time_t)date_to_epoch(&stack_date);
+    struct tm *libc_tm = gmtime(&current);
+    if (libc_tm->tm_year + 1900 != stack_date.year || libc_tm->tm_mon + 1 != stack_date.month ||
+        libc_tm->tm_mday != stack_date.day || libc_tm->tm_wday != stack_date.weekday) {
+        printf("FAIL parse_date(NULL) disagrees with gmtime()\n");
+        failures++;
+    }
+
+    // Test 20: Coarse clock mode, including a cached second requested at another offset
+    set_coarse_clock(true);
+    before = time(NULL);
+    parse_date(NULL, 0, &stack_date);
+    arcdate_t shifted;
+    parse_date(NULL, 180, &shifted);
+    after = time(NULL);
+    set_coarse_clock(false);
+    // The coarse clock may trail the precise one by a kernel tick
+    if (date_to_epoch(&stack_date) < (int64_t)before - 1 || date_to_epoch(&stack_date) > (int64_t)after) {
+        printf("FAIL coarse parse_date(NULL) is not the current time\n");
+        failures++;
+    }
+    if (shifted.gmt_offset != 180 || date_to_epoch(&shifted) - date_to_epoch(&stack_date) > 1 ||
+        date_to_epoch(&shifted) < date_to_epoch(&stack_date)) {
+        printf("FAIL coarse parse_date(NULL, 180) ignored the offset\n");
+        failures++;
+    }
+
+    // Test 21: Packed dates round-trip and order by instant regardless of offset
+    arcdate_t early, late, restored;
+    parse_date("Sun, 06 Nov 1994 08:49:37 GMT", 300, &early);   // 13:49 at +5
+    parse_date("Sun, 06 Nov 1994 09:00:00 GMT", -480, &late);  // 01:00 at -8
+    arcdate_packed_t packed_early = pack_date(&early);
+    arcdate_packed_t packed_late = pack_date(&late);
+    if (!(packed_early < packed_late)) {
+        printf("FAIL packed dates are not ordered by instant\n");
+        failures++;
+    }
+    if (unpack_date(packed_late, &restored) != ARCDATE_OK || memcmp(&restored, &late, sizeof late) != 0) {
+        printf("FAIL unpack_date did not restore every field\n");
+        failures++;
+    }
+    epoch_to_date(-62135596800, 0, &restored); // 0001-01-01, a Monday
+    if (unpack_date(pack_date(&restored), &early) != ARCDATE_OK || memcmp(&restored, &early, sizeof early) != 0) {
+        printf("FAIL packed round trip of year 1\n");
+        failures++;
+    }
+    if (unpack_date(ARCDATE_PACKED_INVALID, &restored) != ARCDATE_ERR_FORMAT) {
+        printf("FAIL unpack_date accepted ARCDATE_PACKED_INVALID\n");
+        failures++;
+    }
+    const char *leap_seconds[] = { "2016-12-31T23:59:60Z", "2017-01-01T02:59:60+03:00" };
+    for (size_t i = 0; i < sizeof(leap_seconds) / sizeof(leap_seconds[0]); i++) {
+        parse_rfc3339(leap_seconds[i], strlen(leap_seconds[i]), &late);
+        packed_late = pack_date(&late);
+        if (unpack_date(packed_late, &restored) != ARCDATE_OK || memcmp(&restored, &late, sizeof late) != 0 ||
+            !(packed_early < packed_late)) {
+            printf("FAIL packed round trip of leap second %s\n", leap_seconds[i]);
+            failures++;
+        }
+    }
+    late.second = 61;
+    if (pack_date(&late) != ARCDATE_PACKED_INVALID) {
+        printf("FAIL pack_date accepted second 61\n");
+        failures++;
+    }
+
+    // Test 22: Comparison and difference honour each date's own offset
+    parse_date("Wed, 21 Oct 2015 07:28:00 GMT", 180, &early);  // 10:28 at +3
+    parse_date("Wed, 21 Oct 2015 07:28:00 GMT", -300, &late);  // 02:28 at -5, same instant
+    if (compare_dates(&early, &late) != 0 || diff_seconds(&early, &late) != 0) {
+        printf("FAIL same instant at different offsets compared unequal\n");
+        failures++;
+    }
+    add_minutes(&late, 90);
+    if (compare_dates(&early, &late) >= 0 || compare_dates(&late, &early) <= 0 ||
+        diff_seconds(&late, &early) != 5400 || diff_seconds(&early, &late) != -5400) {
+        printf("FAIL compare_dates/diff_seconds across offsets\n");
+        failures++;
+    }
+
+    // Test 23: Conditional requests against a resource modified at 1445412480 (Wed, 21 Oct 2015 07:28:00 GMT)
+    const char *same_second = "Wed, 21 Oct 2015 07:28:00 GMT";
+    const char *one_second_before = "Wednesday, 21-Oct-15 07:27:59 GMT";
+    const char *next_year = "Fri Jan  1 00:00:00 2016";
+    if (if_modified_since(same_second, strlen(same_second), 1445412480) != ARCDATE_NOT_MODIFIED ||
+        if_modified_since(next_year, strlen(next_year), 1445412480) != ARCDATE_NOT_MODIFIED ||
+        if_modified_since(one_second_before, strlen(one_second_before), 1445412480) != ARCDATE_PROCEED ||
+        if_modified_since("yesterday", 9, 1445412480) != ARCDATE_PROCEED) {
+        printf("FAIL if_modified_since\n");
+        failures++;
+    }
+    if (if_unmodified_since(same_second, strlen(same_second), 1445412480) != ARCDATE_PROCEED ||
+        if_unmodified_since(one_second_before, strlen(one_second_before), 1445412480) != ARCDATE_PRECONDITION_FAILED ||
+        if_unmodified_since("yesterday", 9, 1445412480) != ARCDATE_PROCEED) {
+        printf("FAIL if_unmodified_since\n");
+        failures++;
+    }
+
+    // Test 24: Nanoseconds survive arithmetic and conversion, carry into the seconds and are printed by to_rfc3339_buf only
+    parse_date("Wed, 31 Dec 2014 23:59:59 GMT", 0, &stack_date);
+    add_nanoseconds(&stack_date, 1250000000);                  // 1.25 s later: Thu, 01 Jan 2015 00:00:00.25
+    convert(&stack_date, 180);
+    add_minutes(&stack_date, 30);
+    char fraction_buf[ARCDATE_STRING_MAX];
+    to_rfc3339_buf(&stack_date, fraction_buf, sizeof(fraction_buf));
+    expect_str("nanosecond carry", fraction_buf, "2015-01-01T03:30:00.250+03:00");
+    to_date_string_buf(&stack_date, fraction_buf, sizeof(fraction_buf));
+    expect_str("no fraction in date string", fraction_buf, "Thu, 01 Jan 2015 03:30:00 GMT+3");
+    add_nanoseconds(&stack_date, -500000000);                  // borrows a second
+    add_seconds(&stack_date, -86400);
+    to_rfc3339_buf(&stack_date, fraction_buf, sizeof(fraction_buf));
+    expect_str("nanosecond borrow", fraction_buf, "2014-12-31T03:29:59.750+03:00");
+    early = stack_date;
+    early.nanosecond = 0;
+    if (compare_dates(&early, &stack_date) >= 0 || diff_seconds(&stack_date, &early) != 0) {
+        printf("FAIL nanoseconds do not break compare_dates ties\n");
+        failures++;
+    }
+    parse_date(NULL, 0, &stack_date);
+    if (stack_date.nanosecond < 0 || stack_date.nanosecond > 999999999) {
+        printf("FAIL parse_date(NULL) nanosecond out of range: %d\n", stack_date.nanosecond);
+        failures++;
+    }
+
+    // Test 25: RFC 3339 timestamps parse at their own offset and format back byte for byte
+    const char *rfc3339_cases[] = {
+        "2015-10-21T07:28:00Z",
+        "2015-10-21T10:28:00.123+03:00",
+        "2015-10-21T12:58:00+05:30",
+        "1994-11-06T08:49:37.000001-05:00",
+        "2016-12-31T23:59:60.999999999Z",
+    };
+    for (size_t i = 0; i < sizeof(rfc3339_cases) / sizeof(rfc3339_cases[0]); i++) {
+        char rfc3339_buf[ARCDATE_RFC3339_MAX];
+        if (parse_rfc3339(rfc3339_cases[i], strlen(rfc3339_cases[i]), &stack_date) != ARCDATE_OK) {
+            printf("FAIL parse_rfc3339 rejected \"%s\"\n", rfc3339_cases[i]);
+            failures++;
+            continue;
+        }
+        to_rfc3339_buf(&stack_date, rfc3339_buf, sizeof(rfc3339_buf));
+        expect_str("RFC 3339 round trip", rfc3339_buf, rfc3339_cases[i]);
+    }
+    parse_rfc3339("2015-10-21t10:28:00.5+03:00", 27, &stack_date);
+    to_date_string_buf(&stack_date, fraction_buf, sizeof(fraction_buf));
+    expect_str("parse_rfc3339 fields", fraction_buf, "Wed, 21 Oct 2015 10:28:00 GMT+3");
+    if (stack_date.nanosecond != 500000000) {
+        printf("FAIL parse_rfc3339 fraction\n");
+        failures++;
+    }
+    if (date_to_epoch(&stack_date) != 1445412480) {
+        printf("FAIL parse_rfc3339 epoch\n");
+        failures++;
+    }
+    const char *bad_rfc3339[] = {
+        "2015-10-21T07:28:00", "2015-02-29T07:28:00Z", "2015-10-21T07:28:00.Z",
+        "2015-10-21T07:28:00+05:60", "2015-10-21T24:00:00Z", "2015/10/21T07:28:00Z",
+    };
+    for (size_t i = 0; i < sizeof(bad_rfc3339) / sizeof(bad_rfc3339[0]); i++) {
+        if (parse_rfc3339(bad_rfc3339[i], strlen(bad_rfc3339[i]), &stack_date) != ARCDATE_ERR_FORMAT) {
+            printf("FAIL parse_rfc3339 accepted \"%s\"\n", bad_rfc3339[i]);
+            failures++;
+        }
+    }
+    parse_rfc3339("2015-10-21T07:28:00Z", 20, &stack_date);
+    stack_date.gmt_offset = 600000;
+    if (to_rfc3339_buf(&stack_date, fraction_buf, sizeof(fraction_buf)) != 0 || fraction_buf[0] != '\0') {
+        printf("FAIL to_rfc3339_buf accepted an offset beyond 23:59\n");
+        failures++;
+    }
+    stack_date.gmt_offset = 0;
+    stack_date.nanosecond = -1;
+    if (to_rfc3339_buf(&stack_date, fraction_buf, sizeof(fraction_buf)) != 0 || fraction_buf[0] != '\0') {
+        printf("FAIL to_rfc3339_buf accepted a negative nanosecond\n");
+        failures++;
+    }
+    stack_date.nanosecond = 0;
+    stack_date.hour = 100;
+    if (to_rfc3339_buf(&stack_date, fraction_buf, sizeof(fraction_buf)) != 0 || fraction_buf[0] != '\0') {
+        printf("FAIL to_rfc3339_buf accepted hour 100\n");
+        failures++;
+    }
+    stack_date.hour = 7;
+    stack_date.month = -3;
+    if (to_rfc3339_buf(&stack_date, fraction_buf, sizeof(fraction_buf)) != 0 || fraction_buf[0] != '\0') {
+        printf("FAIL to_rfc3339_buf accepted month -3\n");
+        failures++;
+    }
+
+    // Test 26: Offsets that are not whole hours (India, Nepal, Newfoundland)
+    parse_date("Wed, 21 Oct 2015 07:28:00 GMT", 330, &stack_date);
+    to_date_string_buf(&stack_date, fraction_buf, sizeof(fraction_buf));
+    expect_str("GMT+5:30", fraction_buf, "Wed, 21 Oct 2015 12:58:00 GMT+5:30");
+    convert(&stack_date, 345);
+    to_date_string_buf(&stack_date, fraction_buf, sizeof(fraction_buf));
+    expect_str("GMT+5:45", fraction_buf, "Wed, 21 Oct 2015 13:13:00 GMT+5:45");
+    convert(&stack_date, -210);
+    to_date_string_buf(&stack_date, fraction_buf, sizeof(fraction_buf));
+    expect_str("GMT-3:30", fraction_buf, "Wed, 21 Oct 2015 03:58:00 GMT-3:30");
+    if (date_to_epoch(&stack_date) != 1445412480) {
+        printf("FAIL date_to_epoch at GMT-3:30\n");
+        failures++;
+    }
+    epoch_to_date(0, -30, &stack_date);
+    to_date_string_buf(&stack_date, fraction_buf, sizeof(fraction_buf));
+    expect_str("GMT-0:30", fraction_buf, "Wed, 31 Dec 1969 23:30:00 GMT-0:30");
+    // Whole-hour steps back from the top of the hour
+    parse_date("Wed, 21 Oct 2015 00:00:00 GMT", -60, &stack_date);
+    to_date_string_buf(&stack_date, fraction_buf, sizeof(fraction_buf));
+    expect_str("GMT-1 at midnight", fraction_buf, "Tue, 20 Oct 2015 23:00:00 GMT-1");
+
+    // Test 27: Named time zones with daylight saving time
+    const arcdate_zone_t *berlin = find_zone("Europe/Berlin");
+    const struct {
+        const char *zone;
+        int64_t epoch;
+        const char *want;
+    } zone_cases[] = {
+        { "Europe/Berlin", 1445412480, "Wed, 21 Oct 2015 09:28:00 GMT+2" },
+        { "Europe/Berlin", 1449403200, "Sun, 06 Dec 2015 13:00:00 GMT+1" },
+        { "Europe/Berlin", 1711846799, "Sun, 31 Mar 2024 01:59:59 GMT+1" },   // last second of winter time
+        { "Europe/Berlin", 1711846800, "Sun, 31 Mar 2024 03:00:00 GMT+2" },
+        { "Europe/Berlin", 5695963200, "Wed, 01 Jul 2150 14:00:00 GMT+2" },   // past the compiled table
+        { "Australia/Sydney", 1452168000, "Thu, 07 Jan 2016 23:00:00 GMT+11" },
+        { "Australia/Sydney", 1445412480, "Wed, 21 Oct 2015 18:28:00 GMT+11" },
+        { "America/St_Johns", 1445412480, "Wed, 21 Oct 2015 04:58:00 GMT-2:30" },
+        { "Asia/Kolkata", 1445412480, "Wed, 21 Oct 2015 12:58:00 GMT+5:30" },
+    };
+    for (size_t i = 0; i < sizeof(zone_cases) / sizeof(zone_cases[0]); i++) {
+        epoch_to_date(zone_cases[i].epoch, 0, &stack_date);
+        if (convert_tz(&stack_date, find_zone(zone_cases[i].zone)) != ARCDATE_OK) {
+            printf("FAIL convert_tz to %s\n", zone_cases[i].zone);
+            failures++;
+            continue;
+        }
+        to_date_string_buf(&stack_date, fraction_buf, sizeof(fraction_buf));
+        expect_str(zone_cases[i].zone, fraction_buf, zone_cases[i].want);
+    }
+    if (!berlin || berlin != find_zone("Europe/Berlin") || zone_offset(berlin, 1445412480) != 120 ||
+        find_zone("Mars/Olympus_Mons") != NULL) {
+        printf("FAIL find_zone\n");
+        failures++;
+    }
+    // Instants before an embedded rule took effect are rejected, not guessed
+    const struct {
+        const char *zone;
+        int64_t epoch;
+    } early_cases[] = {
+        { "Europe/Berlin", -299851200 },      // 1960-07-01: Berlin had no summer time
+        { "America/Sao_Paulo", 1516017600 },  // 2018-01-15: Brazil still had summer time
+        { "Europe/Moscow", 1338552000 },      // 2012-06-01: Moscow was at +4
+        { "America/New_York", 1143028800 },   // 2006-03-22: pre-2007 US rules
+    };
+    for (size_t i = 0; i < sizeof(early_cases) / sizeof(early_cases[0]); i++) {
+        epoch_to_date(early_cases[i].epoch, 0, &stack_date);
+        early = stack_date;
+        if (zone_offset(find_zone(early_cases[i].zone), early_cases[i].epoch) != ARCDATE_INVALID_OFFSET ||
+            convert_tz(&stack_date, find_zone(early_cases[i].zone)) != ARCDATE_ERR_RANGE ||
+            memcmp(&stack_date, &early, sizeof early) != 0) {
+            printf("FAIL %s accepted an instant before its rule\n", early_cases[i].zone);
+            failures++;
+        }
+    }
+
+    // Test 28: Zones from the system tz database, which is not always installed
+    const arcdate_zone_t *loaded = NULL, *loaded_again = NULL;
+    arcdate_status_t load_status = load_zone("Europe/Berlin", &loaded);
+    if (load_status == ARCDATE_ERR_IO) {
+        printf("Skipping load_zone history checks: no system tz database\n");
+    } else if (load_status != ARCDATE_OK || load_zone("Europe/Berlin", &loaded_again) != ARCDATE_OK ||
+               loaded != loaded_again || loaded == find_zone("Europe/Berlin") || zone_offset(loaded, 1445412480) != 120) {
+        printf("FAIL load_zone(\"Europe/Berlin\")\n");
+        failures++;
+    } else if (zone_offset(loaded, 173448000) != 60 || zone_offset(loaded, -299851200) != 60) {
+        // West Germany had no summer time in 1975 or 1960
+        printf("FAIL load_zone lost the zone history\n");
+        failures++;
+    }
+    if (load_zone("../../etc/passwd", &loaded) != ARCDATE_ERR_FORMAT || load_zone("Mars/Olympus_Mons", &loaded) != ARCDATE_ERR_IO) {
+        printf("FAIL load_zone accepted a bad name\n");
+        failures++;
+    }
+
+    // Test 29: Every kernel the build and CPU support passes the tables of Tests 7, 8 and 15
+    const struct {
+        arcdate_kernel_t kernel;
+        const char *name;
+    } kernels[] = {
+        { ARCDATE_KERNEL_SCALAR, "scalar" },
+        { ARCDATE_KERNEL_SSE42, "SSE4.2" },
+        { ARCDATE_KERNEL_AVX2, "AVX2" },
+    };
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        if (!set_imf_kernel(kernels[k].kernel)) continue;
+        check_imf_dates(kernels[k].name);
+        check_name_lookup(kernels[k].name);
+        check_legacy_dates(kernels[k].name);
+    }
+    if (!set_imf_kernel(ARCDATE_KERNEL_AUTO) || set_imf_kernel((arcdate_kernel_t)42)) {
+        printf("FAIL set_imf_kernel\n");
+        failures++;
+    }
+
     printf("All tests completed.\n");
-    return 0;
+    return failures ? 1 : 0;
 }
\ No newline at end of file